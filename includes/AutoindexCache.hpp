@@ -0,0 +1,59 @@
+/**
+ * @file AutoindexCache.hpp
+ * @author ghan, jiskim, yongjule
+ * @brief Memory-budgeted LRU cache of rendered autoindex listings
+ * @date 2022-11-27
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef INCLUDES_AUTOINDEXCACHE_HPP_
+#define INCLUDES_AUTOINDEXCACHE_HPP_
+
+#include <sys/types.h>
+
+#include <ctime>
+#include <list>
+#include <map>
+#include <string>
+
+#define AUTOINDEX_CACHE_BUDGET 8388608  // 캐시 전체 메모리 한도, 8MB
+
+class AutoindexCache {
+ public:
+  AutoindexCache(void);
+  ~AutoindexCache(void);
+
+  bool Find(const std::string& kDir, time_t mtime, ino_t inode,
+            std::string& listing);
+  bool Peek(const std::string& kDir, time_t& mtime, ino_t& inode) const;
+  void Insert(const std::string& kDir, time_t mtime, ino_t inode,
+              const std::string& kListing);
+  void InvalidatePrefix(const std::string& kPrefix);
+  void Clear(void);
+
+ private:
+  typedef std::list<std::string> LruList;  // front 가 가장 최근에 쓰인 경로
+
+  struct Entry {
+    std::string listing;  // autoindex 페이지 전체
+    time_t mtime;         // 페이지를 만들 때 디렉토리 수정 시각
+    ino_t inode;
+    LruList::iterator lru_it;
+  };
+
+  typedef std::map<std::string, Entry> EntryMap;
+
+  EntryMap entries_;
+  LruList lru_;
+  size_t used_;  // 캐시된 페이지 크기 합
+
+  AutoindexCache(const AutoindexCache& kOrigin);
+  AutoindexCache& operator=(const AutoindexCache& kOrigin);
+
+  void Erase(EntryMap::iterator it);
+};
+
+extern AutoindexCache g_autoindex_cache;
+
+#endif  // INCLUDES_AUTOINDEXCACHE_HPP_
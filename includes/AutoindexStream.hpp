@@ -0,0 +1,50 @@
+/**
+ * @file AutoindexStream.hpp
+ * @author ghan, jiskim, yongjule
+ * @brief Render autoindex entries and stream unsorted listings in chunks
+ * @date 2022-11-28
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef INCLUDES_AUTOINDEXSTREAM_HPP_
+#define INCLUDES_AUTOINDEXSTREAM_HPP_
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ParseUtils.hpp"
+#include "UriParser.hpp"
+
+#define AUTOINDEX_BATCH 1024  // chunk 하나로 보낼 최대 엔트리 수
+#define AUTOINDEX_TAG_LEN 18  // "<a href='./" + "'>" + "</a>\n"
+#define AUTOINDEX_TAIL "</pre><hr></body></html>"
+
+class AutoindexStream {
+ public:
+  AutoindexStream(std::vector<std::string>& names, const std::string& kPath);
+  ~AutoindexStream(void);
+
+  void Fill(std::string& chunk);
+  bool is_done(void) const;
+
+  static std::string FormatHead(const std::string& kPath);
+  static bool ReadEntry(int dir_fd, const dirent* kEnt, std::string& name);
+  static void AppendEntry(std::string& listing, const std::string& kName);
+  static bool IsOrdered(const std::string& kLhs, const std::string& kRhs);
+
+ private:
+  std::vector<std::string> names_;  // 작업 스레드가 읽은 순서의 엔트리 이름
+  size_t next_;                     // 다음 chunk 로 보낼 엔트리 위치
+  bool is_done_;
+  std::string head_;  // 첫 chunk 앞에 붙일 페이지 앞부분, 보낸 후 비움
+
+  AutoindexStream(const AutoindexStream& kOrigin);
+  AutoindexStream& operator=(const AutoindexStream& kOrigin);
+};
+
+#endif  // INCLUDES_AUTOINDEXSTREAM_HPP_
@@ -10,8 +10,6 @@
 #ifndef INCLUDES_CGIMANAGER_HPP_
 #define INCLUDES_CGIMANAGER_HPP_
 
-#include <libgen.h>
-
 #include <csignal>
 
 #include "ResponseManager.hpp"
@@ -47,22 +45,25 @@ class CgiManager : public ResponseManager {
   int in_fd_[2];
   int out_fd_[2];
   size_t write_offset_;
+  size_t content_len_;  // response_content_ 중 실제로 읽은 길이
   std::string header_read_buf_;
   std::string& response_content_;
 
   // child
   void DupFds(void);
-  void ParseScriptCommandLine(std::vector<std::string>& arg_vector,
-                              std::string query);
-  void ExecuteScript(const char* kSuccessPath, char* const* kEnv);
+  void ExecuteScript(const char* kScriptDir, char* const* kArgv,
+                     char* const* kEnv);
 
   // parent
   void SetIpc(void);
+  void ParseScriptCommandLine(std::vector<std::string>& arg_vector,
+                              std::string query);
   bool OpenPipes(void);
-  bool CheckFileMode(const char* kPath);
+  bool CheckFileMode(void);
   void PassContent(void);
   bool ReceiveCgiHeaderFields(ResponseHeaderMap& header, size_t header_end);
   bool ReceiveCgiResponse(ResponseHeaderMap& header);
+  bool ReceiveCgiContent(void);
   bool ParseCgiHeader(ResponseHeaderMap& header);
   int DetermineResponseType(ResponseHeaderMap& header);
   void SetInternalServerError(void);
@@ -11,21 +11,26 @@
 #define INCLUDES_CONNECTION_HPP_
 
 #include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
 
 #include <cerrno>
+#include <climits>
 #include <cstring>
-#include <queue>
+#include <deque>
 
 #include "CgiManager.hpp"
 #include "FileManager.hpp"
 #include "HeaderFormatter.hpp"
 #include "HttpParser.hpp"
+#include "OpenFileCache.hpp"
 #include "PathResolver.hpp"
 #include "Router.hpp"
+#include "StaticResponseCache.hpp"
 
 #define PRINT_REQ_LOG(req)                                                    \
   std::cout << "--------------------- REQUEST ---------------------\nHost : " \
@@ -38,6 +43,10 @@
 
 #define BUFFER_SIZE 4096
 
+// pipelining
+#define PIPELINE_REQUEST_MAX 16  // 한 번의 이벤트에서 처리할 최대 요청 수
+#define RESPONSE_QUEUE_MAX 32    // 전송 대기 중인 최대 응답 수
+
 // connection status
 #define KEEP_ALIVE 0
 #define KEEP_READING 1
@@ -45,13 +54,14 @@
 #define CLOSE 3
 #define CONNECTION_ERROR 4
 
+// sendfile 을 쓰지 않는 파일 응답을 나눠 읽을 버퍼 크기
+#define STREAM_WINDOW_SIZE 262144  // 256KB
+
 // send status
 #define KEEP_SENDING 0
 #define SEND_NEXT 1
 #define SEND_FINISHED 2
 
-#define SEND_BUFF_SIZE 32768  // 32KB
-
 class Connection {
  public:
   Connection(void);
@@ -63,13 +73,16 @@ class Connection {
   ResponseManager::IoFdPair HandleRequest(void);
   ResponseManager::IoFdPair ExecuteMethod(int event_fd);
 
-  void Send(void);
+  void Send(size_t send_space);
 
   void SetAttributes(const int kFd, const std::string& kClientAddr,
                      const HostPortPair& kHostPortPair,
                      ServerRouter& server_router);
 
   bool IsResponseBufferReady(void) const;
+  bool HasPipelinedRequest(void) const;
+  bool IsResponseQueueFull(void) const;
+  bool CanHandleNextRequest(int handled_count) const;
   bool IsHttpPairSynced(void) const;
 
   int get_send_status(void) const;
@@ -77,7 +90,7 @@ class Connection {
   int get_fd(void) const;
 
  private:
-  typedef std::queue<ResponseBuffer> ResponseQueue;
+  typedef std::deque<ResponseBuffer> ResponseQueue;
 
   class ResponseManagerMap : public std::map<int, ResponseManager*> {
    public:
@@ -109,10 +122,16 @@ class Connection {
 
   int connection_status_;
   int send_status_;
+  size_t send_budget_;
+  bool tcp_nopush_;
+  bool is_corked_;
   HostPortPair host_port_;
   std::string client_addr_;
   std::string buffer_;
+  size_t buffer_offset_;
   ResponseQueue response_queue_;
+  std::string stream_buf_;  // 전송 중인 파일 응답의 body 일부
+  off_t stream_pos_;        // stream_buf_ 첫 바이트의 파일 위치
   ResponseManagerMap response_manager_map_;
 
   HttpParser parser_;
@@ -130,7 +149,15 @@ class Connection {
       ResponseManager** manager, std::string& local_redir_path);
   int ValidateLocalRedirPath(std::string& path, RequestLine& req);
 
-  size_t SetIov(struct iovec* iov, ResponseBuffer& res);
+  size_t SetIov(struct iovec* iov, size_t send_max, size_t& iov_len,
+                ResponseBuffer*& file_res);
+  ssize_t SendBuffers(size_t send_max);
+  ssize_t SendFile(ResponseBuffer& res, off_t file_pos, size_t body_len,
+                   struct iovec* iov, size_t iov_cnt, size_t iov_len);
+  bool FillStreamWindow(int file_fd, off_t file_pos);
+  void FillAutoindexChunk(ResponseBuffer& response);
+  void SetNoPush(bool is_corked);
+  void UpdateSentResponses(size_t sent_bytes);
 
   template <typename T>
   T SetConnectionError(const std::string& kMsg);
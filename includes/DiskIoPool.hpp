@@ -0,0 +1,91 @@
+/**
+ * @file DiskIoPool.hpp
+ * @author ghan, jiskim, yongjule
+ * @brief Worker thread pool for blocking filesystem calls
+ * @date 2022-12-05
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef INCLUDES_DISKIOPOOL_HPP_
+#define INCLUDES_DISKIOPOOL_HPP_
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "OpenFileCache.hpp"
+
+#define DISK_IO_THREADS 4  // 작업 스레드 수
+
+struct DiskTask;
+typedef void (*DiskRoutine)(DiskTask& task);
+
+/**
+ * @brief 작업 스레드에서 실행할 blocking 파일 시스템 작업, 입력과 결과를 모두
+ * 직접 가지고 있어 요청한 매니저가 먼저 사라져도 안전하게 끝까지 실행됨
+ * 작업 스레드는 캐시 같은 전역 상태를 건드리지 않고, 결과는 이벤트 루프가 반영
+ *
+ */
+struct DiskTask {
+  DiskRoutine routine;
+  int status;  // 작업 결과 상태 코드, 성공 시 0
+  std::string path;
+  int root_fd;      // 경로가 속한 root 디렉토리 fd
+  size_t root_len;  // 경로 중 root_fd 가 가리키는 부분의 길이
+  std::string content;                     // 파일에 쓸 내용
+  std::vector<std::string> paths;          // open 할 경로들
+  std::vector<OpenFileCache::Info> infos;  // paths 를 open 한 결과
+  off_t read_max;  // 이 크기 이하인 파일은 contents 에 읽어 둠
+  std::vector<std::string> contents;  // paths 를 읽은 내용, 안 읽었으면 빈 값
+  time_t mtime;  // 디렉토리 수정 시각 (입력: 캐시된 페이지의 값, 결과: 현재 값)
+  ino_t inode;   // 디렉토리 inode (mtime 과 같음)
+  std::vector<std::string> names;  // 읽은 디렉토리 엔트리 이름
+  bool is_done;
+  int done_fd;  // 완료 알림 pipe 의 쓰기 쪽
+  int refs;     // 요청한 매니저 + 작업 스레드 참조 수
+
+  DiskTask(DiskRoutine routine)
+      : routine(routine),
+        status(0),
+        root_fd(AT_FDCWD),
+        root_len(0),
+        read_max(-1),
+        mtime(0),
+        inode(0),
+        is_done(false),
+        done_fd(-1),
+        refs(1) {}
+};
+
+class DiskIoPool {
+ public:
+  DiskIoPool(void);
+  ~DiskIoPool(void);
+
+  bool Start(void);
+  int Submit(DiskTask* task);
+  bool IsDone(DiskTask* task);
+  void Release(DiskTask* task);
+
+ private:
+  pthread_mutex_t mutex_;
+  pthread_cond_t cond_;
+  std::deque<DiskTask*> queue_;
+  int thread_count_;
+
+  DiskIoPool(const DiskIoPool& kOrigin);
+  DiskIoPool& operator=(const DiskIoPool& kOrigin);
+
+  static void* Work(void* pool);
+  DiskTask* Pop(void);
+  void Complete(DiskTask* task);
+};
+
+extern DiskIoPool g_disk_io_pool;
+
+#endif  // INCLUDES_DISKIOPOOL_HPP_
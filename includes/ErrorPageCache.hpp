@@ -0,0 +1,58 @@
+/**
+ * @file ErrorPageCache.hpp
+ * @author ghan, jiskim, yongjule
+ * @brief Error pages loaded at startup and pre-rendered default error bodies
+ * @date 2022-11-29
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef INCLUDES_ERRORPAGECACHE_HPP_
+#define INCLUDES_ERRORPAGECACHE_HPP_
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "ResponseData.hpp"
+
+class ErrorPageCache {
+ public:
+  struct Page {
+    int err;  // 읽기 실패 시 errno, 성공 시 0
+    std::string content;
+
+    Page(void) : err(0) {}
+  };
+
+  ErrorPageCache(void);
+
+  void RenderDefaultBodies(void);
+  void Load(const std::string& kPath);
+  void Reload(const std::string& kPath);
+  void ReloadPrefix(const std::string& kPrefix);
+  const Page* Find(const std::string& kPath) const;
+  const std::string& GetDefaultBody(int status);
+
+ private:
+  typedef std::map<std::string, Page> PageMap;  // key: 에러 페이지 경로
+  typedef std::map<int, std::string> BodyMap;   // key: 상태 코드
+
+  PageMap pages_;
+  BodyMap default_bodies_;
+
+  ErrorPageCache(const ErrorPageCache& kOrigin);
+  ErrorPageCache& operator=(const ErrorPageCache& kOrigin);
+
+  void ReadPage(const std::string& kPath, Page& page);
+  std::string RenderDefaultBody(int status);
+};
+
+extern ErrorPageCache g_error_page_cache;
+
+#endif  // INCLUDES_ERRORPAGECACHE_HPP_
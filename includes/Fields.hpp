@@ -0,0 +1,69 @@
+/**
+ * @file Fields.hpp
+ * @author ghan, jiskim, yongjule
+ * @brief Flat HTTP header field table with perfect-hashed known fields
+ * @date 2022-11-22
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef INCLUDES_FIELDS_HPP_
+#define INCLUDES_FIELDS_HPP_
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define FIELDS_RESERVE 16
+
+class Fields {
+ public:
+  enum Id {
+    kHost = 0,
+    kContentLength,
+    kTransferEncoding,
+    kConnection,
+    kContentType,
+    kExpect,
+    kRange,
+    kIfRange,
+    kIfNoneMatch,
+    kIfModifiedSince,
+    kAcceptEncoding,
+    kKnownFieldCount,
+    kUnknown = kKnownFieldCount
+  };
+
+  typedef std::vector<std::string> Values;
+  typedef std::pair<std::string, Values> Node;
+  typedef std::vector<Node>::iterator iterator;
+  typedef std::vector<Node>::const_iterator const_iterator;
+
+  Fields(void);
+
+  static Id Lookup(const char* kName, size_t len);
+  static Id Lookup(const std::string& kName);
+
+  Values& operator[](const std::string& kName);
+  iterator find(Id id);
+  const_iterator find(Id id) const;
+  iterator find(const std::string& kName);
+  const_iterator find(const std::string& kName) const;
+  size_t count(const std::string& kName) const;
+
+  iterator begin(void);
+  iterator end(void);
+  const_iterator begin(void) const;
+  const_iterator end(void) const;
+  size_t size(void) const;
+  bool empty(void) const;
+  void clear(void);
+
+ private:
+  std::vector<Node> nodes_;
+  int known_[kKnownFieldCount];
+};
+
+#endif  // INCLUDES_FIELDS_HPP_
@@ -10,9 +10,17 @@
 #ifndef INCLUDES_FILEMANAGER_HPP_
 #define INCLUDES_FILEMANAGER_HPP_
 
+#include "AutoindexCache.hpp"
+#include "AutoindexStream.hpp"
+#include "DiskIoPool.hpp"
 #include "ResponseManager.hpp"
 
 #define FILE_IDX_MAX 100
+#define RANGE_COUNT_MAX 16      // 한 요청의 최대 Range 범위 수, 넘으면 Range 무시
+#define RANGE_BUFF_MAX 1048576  // multipart Range 로 읽을 최대 바이트 수, 1MB
+#define AUTOINDEX_PAGE_LIMIT 1000  // limit query 가 없을 때 페이지 당 엔트리 수
+#define AUTOINDEX_LIMIT_MAX 10000  // limit query 최대 값
+#define AUTOINDEX_PAGE_MAX 1000000  // page query 최대 값
 
 class FileManager : public ResponseManager {
  public:
@@ -22,32 +30,78 @@ class FileManager : public ResponseManager {
   ResponseManager::IoFdPair Execute(void);
 
  private:
-  int in_fd_;
-  int out_fd_;
-  size_t write_offset_;
+  typedef std::vector<std::pair<off_t, off_t> > RangeVector;  // [first, last]
+
+  struct LoadedFile {
+    OpenFileCache::Info info;  // 읽을 때의 파일 정보 (size, mtime, inode 비교)
+    std::string content;       // 작업 스레드가 읽은 파일 내용
+  };
+
+  typedef std::map<std::string, LoadedFile> LoadedFileMap;
+
+  int in_fd_;             // 작업 스레드의 완료 알림 fd
+  bool is_prefetched_;    // GET 파일들을 이미 open file cache 에 넣었는지
+  bool is_content_read_;  // 캐시할 파일 내용을 작업 스레드에서 읽었는지
+  DiskTask* disk_task_;   // 작업 스레드에서 실행 중인 작업
+  LoadedFileMap loaded_files_;  // 작업 스레드가 읽어 둔 작은 파일들
+  int dir_status_;        // 작업 스레드의 디렉토리 읽기 결과, 읽기 전 -1
+  time_t dir_mtime_;      // 읽은 디렉토리 수정 시각
+  ino_t dir_inode_;
+  time_t dir_read_time_;  // 디렉토리 읽기를 넘긴 시각
+  std::vector<std::string> dir_names_;  // 읽은 디렉토리 엔트리 이름
   std::string output_path_;  // POST output file path
+  std::string file_path_;    // GET 으로 전송하는 파일 (원본 또는 압축 사이드카)
   std::string& response_content_;
 
   // GET
   void Get(void);
+  bool PrefetchFiles(void);
+  void SelectPrecompressed(OpenFileCache::Info& info);
+  void SetValidators(const OpenFileCache::Info& kInfo);
+  bool IsNotModified(const OpenFileCache::Info& kInfo);
+  bool DoesETagMatch(const Fields::Values& kValues, const std::string& kETag);
+  bool ParseRange(off_t size, RangeVector& ranges);
+  off_t ParseBytePos(const std::string& kPos);
+  bool DoesIfRangeMatch(void);
+  void SetRangeBody(const OpenFileCache::Info& kInfo,
+                    const RangeVector& kRanges);
+  void SetMultipartRangeBody(const OpenFileCache::Info& kInfo,
+                             const RangeVector& kRanges, off_t total_len);
+  void SetFileBody(const OpenFileCache::Info& kInfo);
+  bool SetCachedBody(const OpenFileCache::Info& kInfo, bool is_gzip);
+  std::string* FindLoadedContent(const OpenFileCache::Info& kInfo);
+  bool ReadFileContent(const OpenFileCache::Info& kInfo);
+  CachedResponse* LoadCachedResponse(const OpenFileCache::Info& kInfo,
+                                     const std::string& kKey, bool is_gzip,
+                                     const std::string& kContent);
 
   // POST
   void Post(void);
-  ssize_t WriteFile(const std::string& kReqContent);
-  bool FindValidOutputPath(std::string& success_path);
 
   // DELETE
   void Delete(void);
 
+  // 작업 스레드
+  bool RunDiskTask(DiskTask* task);
+  bool CollectDiskTask(void);
+  void ApplyDiskTask(DiskTask& task);
+  static void LoadFiles(DiskTask& task);
+  static void ReadDirectory(DiskTask& task);
+  static bool ReadAutoindexEntries(int dir_fd,
+                                   std::vector<std::string>& names);
+  static void CreateOutputFile(DiskTask& task);
+  static void RemoveFile(DiskTask& task);
+  static int ConvertErrnoToStatus(int err);
+
   // Utils
-  int OpenResource(const char* kPath, const int kFlags);
   ResponseManager::IoFdPair GenerateRedirectPage(void);
-  void CheckFileMode(void);
+  void CheckFileMode(const OpenFileCache::Info& kInfo);
   int GenerateAutoindex(const std::string& kPath);
-  bool DetermineFileType(const std::string& kPath, const dirent* kEnt,
-                         std::vector<std::string>& dir_vector,
-                         std::vector<std::string>& file_vector);
-  void ListAutoindexFiles(std::vector<std::string>& paths);
+  int LoadDirectory(const std::string& kPath, bool is_cached);
+  int StreamAutoindex(const std::string& kPath);
+  bool ParseAutoindexPage(size_t& page, size_t& limit);
+  void AppendAutoindexNav(size_t page, size_t limit, bool has_next);
+  void EraseFileHeaders(void);
   ResponseManager::IoFdPair DetermineSuccessFileExt(void);
   int SetIoComplete(const int kStatus);
 };
@@ -0,0 +1,73 @@
+/**
+ * @file FileWatcher.hpp
+ * @author ghan, jiskim, yongjule
+ * @brief Watch static content roots with kqueue and invalidate file caches
+ * @date 2022-11-25
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef INCLUDES_FILEWATCHER_HPP_
+#define INCLUDES_FILEWATCHER_HPP_
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/event.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+
+#include "AutoindexCache.hpp"
+#include "ErrorPageCache.hpp"
+#include "OpenFileCache.hpp"
+#include "StaticResponseCache.hpp"
+#include "Utils.hpp"
+
+#define FILE_WATCH_MAX 1024  // 감시할 최대 파일/디렉토리 수 (감시 하나당 fd 1개)
+// 감시에 쓸 수 있는 fd 는 RLIMIT_NOFILE 의 1/8, 나머지는 연결과 파일 I/O 용
+#define FILE_WATCH_FD_SHARE 8
+#define FILE_WATCH_FFLAGS \
+  (NOTE_DELETE | NOTE_WRITE | NOTE_EXTEND | NOTE_ATTRIB | NOTE_RENAME | \
+   NOTE_REVOKE)
+
+class FileWatcher {
+ public:
+  FileWatcher(void);
+  ~FileWatcher(void);
+
+  void WatchRoot(int kq, const std::string& kRoot);
+  void WatchFile(int kq, const std::string& kPath);
+  void HandleEvent(const struct kevent& kEvent);
+
+ private:
+  struct Watch {
+    bool is_dir;
+    std::string path;  // 디렉토리는 '/' 로 끝남
+  };
+
+  typedef std::map<int, Watch> WatchMap;  // key: 감시 fd
+  typedef std::set<std::string> WatchedPathSet;
+
+  int kq_;
+  size_t watch_max_;    // fd 한도에 맞춘 최대 감시 수
+  bool is_overflowed_;  // 감시 한도 초과 또는 감시 실패, 유효 시간으로 검증
+  WatchMap watches_;
+  WatchedPathSet watched_paths_;
+  WatchedPathSet pinned_paths_;  // WatchFile 로 감시하는 파일
+
+  FileWatcher(const FileWatcher& kOrigin);
+  FileWatcher& operator=(const FileWatcher& kOrigin);
+
+  bool AddWatch(const std::string& kPath, bool is_dir);
+  bool WatchDirectory(const std::string& kDir);
+  void RemoveWatch(WatchMap::iterator it);
+  void Overflow(const std::string& kReason);
+};
+
+#endif  // INCLUDES_FILEWATCHER_HPP_
@@ -0,0 +1,26 @@
+/**
+ * @file Gzip.hpp
+ * @author ghan, jiskim, yongjule
+ * @brief Compress response content with zlib in gzip format
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef INCLUDES_GZIP_HPP_
+#define INCLUDES_GZIP_HPP_
+
+#include <zlib.h>
+
+#include <string>
+
+#define GZIP_WINDOW_BITS (15 + 16)  // 32KB window + gzip header/trailer
+#define GZIP_MEM_LEVEL 8
+#define GZIP_FILE_MAX 1048576  // 압축해서 캐시할 static 파일 최대 크기, 1MB
+
+class Gzip {
+ public:
+  bool Compress(const char* kSrc, size_t len, int level, std::string& dst);
+};
+
+#endif  // INCLUDES_GZIP_HPP_
@@ -10,18 +10,46 @@
 #ifndef INCLUDES_HEADERFORMATTER_HPP_
 #define INCLUDES_HEADERFORMATTER_HPP_
 
+#include <sys/types.h>
+
+#include <ctime>
+#include <map>
 #include <sstream>
 
+#include "ParseUtils.hpp"
 #include "ResponseData.hpp"
 #include "Utils.hpp"
 
+#define HTTP_DATE_FORMAT "%a, %d %b %Y %H:%M:%S GMT"
+
+#define STATUS_CODE_MIN 100
+#define STATUS_CODE_MAX 599
+#define HEADER_RESERVE 512  // 응답 헤더 버퍼에 미리 잡을 크기
+
 class HeaderFormatter {
  public:
-  std::string FormatCurrentTime(void);
-  std::string FormatAllowed(uint8_t allowed_methods);
+  static void InitStatusLines(void);
+  static void UpdateDate(time_t now);
+  static const std::string& get_date(void);
+  static const std::string& GetExpires(int max_age);
+  static const std::string& GetStatusLine(int status);
+  static const char* GetAllowField(uint8_t allowed_methods);
+  static bool IsServerField(const std::string& kName);
+  static void AppendNumber(std::string& dst, size_t num);
+  static std::string FormatHttpDate(const time_t kTime);
+
+  std::string FormatETag(ino_t inode, off_t size, time_t mtime);
   std::string FormatContentType(bool is_autoindex, const std::string& kExt,
                                 ResponseHeaderMap& header);
-  void ResolveConflicts(ResponseHeaderMap& header);
+
+ private:
+  static time_t date_time_;  // date_ 를 만든 시각
+  static std::string date_;  // Date 헤더 값, 이벤트 루프가 초마다 갱신
+  // 현재 초 기준 Expires 헤더 값, key: max-age
+  static std::map<int, std::string> expires_;
+  // "<status code> <reason phrase>\r\n", index: status code - STATUS_CODE_MIN
+  static std::string status_lines_[STATUS_CODE_MAX - STATUS_CODE_MIN + 1];
+  static const char* kAllowFields_[8];  // index: 허용 method 비트
 };
 
 #endif  // INCLUDES_HEADERFORMATTER_HPP_
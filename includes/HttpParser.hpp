@@ -35,7 +35,7 @@
 #define CHUNKED std::numeric_limits<size_t>::max() - 1
 
 #define CHUNKED_SIZE_LINE_MAX 1024
-#define CHUNK_SIZE_MAX 8192
+#define CHUNK_SIZE_MAX 1048576  // 1MB, config 의 chunk_max 로 변경 가능
 
 class HttpParser {
  public:
@@ -61,29 +61,39 @@ class HttpParser {
 
   HttpParser(void);
 
-  int Parse(std::string& segment);
-  bool DoesNextReqExist(void);
+  int Parse(const std::string& kBuf, size_t& offset);
   void Clear(void);
   void Reset(void);
   Result& get_result(void);
+  void set_chunk_max(size_t chunk_max);
 
  private:
-  enum { kChunkSize = 0, kChunkData, kChunkEnd };
+  enum {
+    kChunkSize = 0,
+    kChunkSizeBWS,
+    kChunkExt,
+    kChunkSizeLF,
+    kChunkData,
+    kChunkDataCR,
+    kChunkDataLF,
+    kChunkEndCR,
+    kChunkEndLF
+  };
 
   bool keep_alive_;
-  uint8_t is_data_;
+  uint8_t chunk_state_;
   int status_;
   size_t body_length_;
   size_t chunk_size_;
+  size_t chunk_line_len_;
+  size_t chunk_max_;
   std::string request_line_buf_;
   std::string header_buf_;
-  std::string chunked_buf_;
-  std::string backup_buf_;
   Result result_;
 
   // Parse request line
-  void SkipLeadingCRLF(std::string& segment);
-  void ReceiveRequestLine(std::string& segment);
+  void SkipLeadingCRLF(const std::string& kBuf, size_t& offset);
+  void ReceiveRequestLine(const std::string& kBuf, size_t& offset);
   void ParseRequestLine(void);
   void TokenizeMethod(size_t& pos);
   void TokenizePath(size_t& pos);
@@ -91,18 +101,18 @@ class HttpParser {
 
   // Parse header - HeaderParser.cpp
   void SkipWhiteSpace(size_t& cursor);
-  void ReceiveHeader(std::string& segment);
+  void ReceiveHeader(const std::string& kBuf, size_t& offset);
   void ParseHeader(void);
   std::string TokenizeFieldName(size_t& cursor);
   void TokenizeFieldValueList(size_t& cursor, std::string& name);
 
-  void ParseFieldValueList(std::list<std::string>& field_value_list,
+  void ParseFieldValueList(Fields::Values& field_value_list,
                            std::map<std::string, size_t>& valid_map,
                            int no_match_status, char delim);
   void ValidateHost(void);
   void DetermineBodyLength(void);
-  void ParseContentLength(std::list<std::string>& content_length);
-  void ParseTransferEncoding(std::list<std::string>& encodings);
+  void ParseContentLength(Fields::Values& content_length);
+  void ParseTransferEncoding(Fields::Values& encodings);
   void ValidateConnection(void);
 
   template <typename InputIterator>
@@ -110,12 +120,11 @@ class HttpParser {
                                                       InputIterator last);
 
   // parse body
-  void ReceiveContent(std::string& segment);
-  void DecodeChunkedContent(std::string& segment);
-  bool ParseChunkData(void);
-  bool ParseChunkSize(void);
-  void ParseChunkEnd(void);
-  bool IgnoreChunkExtension(std::string& chunk_size_line);
+  void ReceiveContent(const std::string& kBuf, size_t& offset);
+  void DecodeChunkedContent(const std::string& kBuf, size_t& offset);
+  size_t ParseChunkSize(const std::string& kSegment, size_t pos);
+  size_t ReceiveChunkData(const std::string& kSegment, size_t pos);
+  size_t ParseChunkDelimiter(const std::string& kSegment, size_t pos);
 
   void UpdateStatus(int http_status, int parser_status);
 };
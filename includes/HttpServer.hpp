@@ -15,6 +15,7 @@
 #include <sys/resource.h>
 
 #include "Connection.hpp"
+#include "FileWatcher.hpp"
 #include "PassiveSockets.hpp"
 #include "Utils.hpp"
 
@@ -33,6 +34,7 @@ class HttpServer {
   typedef std::vector<Connection> ConnectionVector;
   typedef std::map<int, int> IoFdMap;
   typedef std::set<int> CloseIoFdSet;
+  typedef std::set<int> PipelinedFdSet;
 
   int kq_;
   HostPortMap host_port_map_;
@@ -40,17 +42,25 @@ class HttpServer {
   ConnectionVector connections_;
   IoFdMap io_fd_map_;
   CloseIoFdSet close_io_fds_;
+  PipelinedFdSet pipelined_fds_;
+  FileWatcher file_watcher_;
 
   void HandleIOEvent(struct kevent& event);
   void HandleConnectionEvent(struct kevent& event);
 
   void InitKqueue(void);
+  void OpenRoots(void);
+  void OpenLocationRoots(LocationRouter& location_router);
+  void WatchRoots(void);
+  void WatchLocationRoots(const LocationRouter& kLocationRouter);
   void UpdateKqueue(int socket_fd, int16_t ev_filt, uint16_t ev_flag);
   void UpdateTimerEvent(int id, uint16_t ev_filt, intptr_t data);
 
   void AcceptConnection(int socket_fd);
   void ReceiveRequests(const int kSocketFd);
-  void SendResponses(int socket_fd);
+  void ResumeReceiving(const int kSocketFd);
+  void ResumePipelinedRequests(void);
+  void SendResponses(int socket_fd, size_t send_space);
 
   void RegisterIoEvents(ResponseManager::IoFdPair io_fds,
                         const int kSocketFd = -1);
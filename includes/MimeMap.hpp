@@ -0,0 +1,54 @@
+/**
+ * @file MimeMap.hpp
+ * @author ghan, jiskim, yongjule
+ * @brief Perfect hash table of file extensions to MIME types
+ * @date 2022-12-03
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef INCLUDES_MIMEMAP_HPP_
+#define INCLUDES_MIMEMAP_HPP_
+
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#define MIME_SEED_MAX 65536  // bucket 하나의 displacement seed 탐색 한도
+
+typedef std::vector<std::pair<std::string, std::string> >
+    MimeTypeList;  // <extension, MIME type>
+
+/**
+ * @brief 확장자 별 MIME type 저장하는 perfect hash 테이블
+ * 기본 타입과 config 의 types 블록을 로드 시점에 한 번 빌드하고, 조회는 해시 두
+ * 번과 문자열 비교 한 번으로 메모리 할당 없이 끝남
+ *
+ */
+class MimeMap {
+ public:
+  MimeMap(void);
+
+  void Add(const std::string& kExt, const std::string& kType);
+  void Add(const MimeTypeList& kTypes);
+  const std::string* Find(const char* kExt, size_t len) const;
+  const std::string* Find(const std::string& kExt) const;
+
+  static MimeTypeList GetDefaultTypes(void);
+
+ private:
+  typedef std::pair<std::string, std::string> Entry;  // <extension, type>
+
+  std::vector<Entry> entries_;
+  std::vector<uint32_t> seeds_;  // bucket 별 displacement seed
+  std::vector<int> slots_;       // entries_ 의 index, 빈 slot 은 -1
+  uint32_t mask_;                // 테이블 크기 - 1 (2 의 거듭제곱)
+
+  void Build(void);
+  bool Place(uint32_t mask);
+  static uint32_t Hash(const char* kKey, size_t len, uint32_t seed);
+};
+
+#endif  // INCLUDES_MIMEMAP_HPP_
@@ -0,0 +1,111 @@
+/**
+ * @file OpenFileCache.hpp
+ * @author ghan, jiskim, yongjule
+ * @brief LRU cache of open file descriptors and stat results for static files
+ * @date 2022-11-23
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef INCLUDES_OPENFILECACHE_HPP_
+#define INCLUDES_OPENFILECACHE_HPP_
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <ctime>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#define OPEN_FILE_CACHE_MAX 1024  // 최대 엔트리 수
+// 캐시가 가질 수 있는 fd 는 RLIMIT_NOFILE 의 1/4, 나머지는 연결과 감시 용
+#define OPEN_FILE_CACHE_FD_SHARE 4
+// 엔트리 유효 시간 (초), 지나면 다시 open. 감시 중인 root 아래는 무효화 전까지 유효
+#define OPEN_FILE_CACHE_VALID 10
+// 이 크기 이상인 파일은 캐시하지 않고 요청마다 열어 page cache 에 남기지 않음
+// (F_NOCACHE), 64MB
+#define FILE_NOCACHE_MIN 67108864
+// root 디렉토리 fd 기준으로 열 때 root 밖으로 벗어나는 경로 (심볼릭 링크 등) 거부
+#ifdef O_RESOLVE_BENEATH
+#define ROOT_RESOLVE_FLAGS O_RESOLVE_BENEATH
+#else
+#define ROOT_RESOLVE_FLAGS 0
+#endif
+
+class OpenFileCache {
+ public:
+  struct Info {
+    int fd;  // 열린 파일, 디렉토리거나 에러면 -1
+    int err;  // open 실패 시 errno, 성공 시 0
+    bool is_dir;
+    off_t size;
+    time_t mtime;
+    ino_t inode;
+
+    Info(void) : fd(-1), err(0), is_dir(false), size(0), mtime(0), inode(0) {}
+  };
+
+  OpenFileCache(void);
+  ~OpenFileCache(void);
+
+  void FitFdLimit(rlim_t fd_limit);
+  Info Open(const std::string& kPath, int root_fd = AT_FDCWD,
+            size_t root_len = 0);
+  bool IsFresh(const std::string& kPath);
+  void Store(const std::string& kPath, const Info& kInfo);
+  void Release(int fd);
+  void Invalidate(const std::string& kPath);
+  void InvalidatePrefix(const std::string& kPrefix);
+  void Clear(void);
+  void AddWatchedRoot(const std::string& kRoot);
+  void ClearWatchedRoots(void);
+  int OpenRoot(const std::string& kRoot);
+
+  static Info Load(const std::string& kPath, int root_fd = AT_FDCWD,
+                   size_t root_len = 0);
+  static int OpenDir(const std::string& kPath, int root_fd = AT_FDCWD,
+                     size_t root_len = 0);
+  static const char* GetRelativePath(const std::string& kPath,
+                                     size_t root_len);
+  static ssize_t ReadFull(int fd, char* buf, size_t len, off_t offset);
+  static void AdviseRead(int fd, off_t offset, size_t len);
+
+ private:
+  typedef std::list<std::string> LruList;  // front 가 가장 최근에 쓰인 경로
+
+  struct Entry {
+    Info info;
+    time_t validated;
+    LruList::iterator lru_it;
+  };
+
+  typedef std::map<std::string, Entry> EntryMap;
+  typedef std::map<int, int> FdRefMap;  // key: fd, value: 참조 수
+  typedef std::vector<std::string> RootVector;
+  typedef std::map<std::string, int> RootFdMap;  // key: root, value: dirfd
+
+  size_t capacity_;  // fd 한도에 맞춘 최대 엔트리 수
+  EntryMap entries_;
+  LruList lru_;
+  FdRefMap fd_refs_;
+  RootVector watched_roots_;  // 변경 시 FileWatcher 가 무효화해 주는 root
+  RootFdMap root_fds_;        // location root 디렉토리 fd, 프로세스 끝까지 유지
+
+  OpenFileCache(const OpenFileCache& kOrigin);
+  OpenFileCache& operator=(const OpenFileCache& kOrigin);
+
+  bool IsWatched(const std::string& kPath) const;
+  bool IsValid(EntryMap::iterator it, time_t now) const;
+  bool IsCacheable(const Info& kInfo) const;
+  Info Acquire(const Info& kInfo);
+  void Erase(EntryMap::iterator it);
+};
+
+extern OpenFileCache g_open_file_cache;
+
+#endif  // INCLUDES_OPENFILECACHE_HPP_
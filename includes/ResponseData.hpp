@@ -13,6 +13,8 @@
 #include <map>
 #include <string>
 
+#include "MimeMap.hpp"
+
 /**
  * @brief 상태 코드 별 메세지 저장하는 구조체
  *
@@ -68,131 +70,6 @@ struct StatusMap : public std::map<int, std::string> {
   }
 };
 
-/**
- * @brief 확장자 별 MIME type 저장하는 구조체
- *
- */
-struct MimeMap : public std::map<std::string, std::string> {
-  MimeMap(void) {
-    this->operator[]("htm") = "text/html;charset=utf-8";
-    this->operator[]("html") = "text/html;charset=utf-8";
-    this->operator[]("shtml") = "text/html;charset=utf-8";
-    this->operator[]("md") = "text/html;charset=utf-8";
-    this->operator[]("css") = "text/css;charset=utf-8";
-    this->operator[]("xml") = "text/xml;charset=utf-8";
-    this->operator[]("txt") = "text/plain;charset=utf-8";
-    this->operator[]("mml") = "text/mathml";
-    this->operator[]("jad") = "text/vnd.sun.j2me.app-descriptor";
-    this->operator[]("wml") = "text/vnd.wap.wml";
-    this->operator[]("htc") = "text/x-component";
-    this->operator[]("gif") = "image/gif";
-    this->operator[]("jpeg") = "image/jpeg";
-    this->operator[]("jpg") = "image/jpeg";
-    this->operator[]("js") = "application/javascript";
-    this->operator[]("atom") = "application/atom+xml";
-    this->operator[]("rss") = "application/rss+xml";
-    this->operator[]("avif") = "image/avif";
-    this->operator[]("png") = "image/png";
-    this->operator[]("svg") = "image/svg+xml";
-    this->operator[]("svgz") = "image/svg+xml";
-    this->operator[]("tif") = "image/tiff";
-    this->operator[]("tiff") = "image/tiff";
-    this->operator[]("wbmp") = "image/vnd.wap.wbmp";
-    this->operator[]("webp") = "image/webp";
-    this->operator[]("ico") = "image/x-icon";
-    this->operator[]("jng") = "image/x-jng";
-    this->operator[]("bmp") = "image/x-ms-bmp";
-    this->operator[]("woff") = "font/woff";
-    this->operator[]("woff2") = "font/woff2";
-    this->operator[]("jar") = "application/java-archive";
-    this->operator[]("war") = "application/java-archive";
-    this->operator[]("ear") = "application/java-archive";
-    this->operator[]("json") = "application/json";
-    this->operator[]("hqx") = "application/mac-binhex40";
-    this->operator[]("doc") = "application/msword";
-    this->operator[]("pdf") = "application/pdf";
-    this->operator[]("ps") = "application/postscript";
-    this->operator[]("eps") = "application/postscript";
-    this->operator[]("ai") = "application/postscript";
-    this->operator[]("rtf") = "application/rtf";
-    this->operator[]("m3u8") = "application/vnd.apple.mpegurl";
-    this->operator[]("kml") = "application/vnd.google-earth.kml+xml";
-    this->operator[]("kmz") = "application/vnd.google-earth.kmz";
-    this->operator[]("xls") = "application/vnd.ms-excel";
-    this->operator[]("eot") = "application/vnd.ms-fontobject";
-    this->operator[]("ppt") = "application/vnd.ms-powerpoint";
-    this->operator[]("odg") = "application/vnd.oasis.opendocument.graphics";
-    this->operator[]("odp") = "application/vnd.oasis.opendocument.presentation";
-    this->operator[]("ods") = "application/vnd.oasis.opendocument.spreadsheet";
-    this->operator[]("odt") = "application/vnd.oasis.opendocument.text";
-    this->operator[]("pptx") =
-        "application/"
-        "vnd.openxmlformats-officedocument.presentationml.presentation";
-    this->operator[]("xlsx") =
-        "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet";
-    this->operator[]("docx") =
-        "application/"
-        "vnd.openxmlformats-officedocument.wordprocessingml.document";
-    this->operator[]("wmlc") = "application/vnd.wap.wmlc";
-    this->operator[]("wasm") = "application/wasm";
-    this->operator[]("7z") = "application/x-7z-compressed";
-    this->operator[]("cco") = "application/x-cocoa";
-    this->operator[]("jardiff") = "application/x-java-archive-diff";
-    this->operator[]("jnlp") = "application/x-java-jnlp-file";
-    this->operator[]("run") = "application/x-makeself";
-    this->operator[]("pl") = "application/x-perl ";
-    this->operator[]("pm") = "application/x-perl";
-    this->operator[]("prc") = "aplication/x-pilot";
-    this->operator[]("pdb") = "application/x-";
-    this->operator[]("rar") = "application/x-rar-compressed";
-    this->operator[]("rpm") = "application/x-redhat-package-manager";
-    this->operator[]("sea") = "application/x-sea";
-    this->operator[]("swf") = "application/x-shockwave-flash";
-    this->operator[]("sit") = "application/x-stuffit";
-    this->operator[]("tcl") = "application/x-tcl";
-    this->operator[]("tk") = "application/x-tcl";
-    this->operator[]("der") = "aplication/x-x509-ca-cer";
-    this->operator[]("pem") = "application/x-x509-ca-cert";
-    this->operator[]("crt") = "application/x-x509-ca-cert";
-    this->operator[]("xpi") = "application/x-xpinstall";
-    this->operator[]("xhtml") = "application/xhtml+xml";
-    this->operator[]("xspf") = "application/xspf+xml";
-    this->operator[]("zip") = "application/zip";
-    this->operator[]("bin") = "application/octet-stream";
-    this->operator[]("exe") = "application/octet-stream";
-    this->operator[]("dll") = "application/octet-stream";
-    this->operator[]("deb") = "application/octet-stream";
-    this->operator[]("dmg") = "application/octet-stream";
-    this->operator[]("iso") = "application/octet-stream";
-    this->operator[]("img") = "application/octet-stream";
-    this->operator[]("msi") = "application/octet-stream";
-    this->operator[]("msp") = "application/octet-stream";
-    this->operator[]("msm") = "application/octet-stream";
-    this->operator[]("mid") = "audio/midi";
-    this->operator[]("midi") = "audio/midi";
-    this->operator[]("kar") = "audio/midi";
-    this->operator[]("mp3") = "audio/mpeg";
-    this->operator[]("ogg") = "audio/ogg";
-    this->operator[]("m4a") = "audio/x-m4a";
-    this->operator[]("ra") = "audio/x-realaudio";
-    this->operator[]("3gpp") = "video/3gpp";
-    this->operator[]("3gp") = "video/3gpp";
-    this->operator[]("ts") = "video/mp2t";
-    this->operator[]("mp4") = "video/mp4";
-    this->operator[]("mpeg") = "video/mpeg";
-    this->operator[]("mpg") = "video/mpeg";
-    this->operator[]("mov") = "video/quicktime";
-    this->operator[]("webm") = "video/webm";
-    this->operator[]("flv") = "video/x-flv";
-    this->operator[]("m4v") = "video/x-m4v";
-    this->operator[]("mng") = "video/x-mng";
-    this->operator[]("asx") = "video/x-ms-asf";
-    this->operator[]("asf") = "video/x-ms-asf";
-    this->operator[]("wmv") = "video/x-ms-wmv";
-    this->operator[]("avi") = "video/x-msvideo";
-  }
-};
-
 extern StatusMap g_status_map;
 extern MimeMap g_mime_map;
 
@@ -15,9 +15,13 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include "ErrorPageCache.hpp"
+#include "Gzip.hpp"
 #include "HeaderFormatter.hpp"
+#include "OpenFileCache.hpp"
 #include "ResponseData.hpp"
 #include "Router.hpp"
+#include "StaticResponseCache.hpp"
 #include "UriParser.hpp"
 #include "Utils.hpp"
 
@@ -80,7 +84,6 @@ class ResponseManager {
  protected:
   bool is_keep_alive_;
   int io_status_;
-  int err_fd_;
   off_t file_size_;
   Result result_;
   Request request_;
@@ -88,7 +91,13 @@ class ResponseManager {
   ResponseBuffer& response_buffer_;
   HeaderFormatter header_formatter_;
 
-  ssize_t ReadFile(int fd);
+  void AppendInvariantHeader(std::string& dst, size_t content_length);
+  bool IsCacheable(void);
+  bool IsCompressible(size_t len);
+  void CompressContent(void);
+  bool AcceptsEncoding(const std::string& kCoding);
+  void AddVaryAcceptEncoding(void);
+  std::string DetermineMimeType(void);
   IoFdPair GetErrorPage(void);
   std::string ParseExtension(const std::string& kSuccessPath);
   virtual int SetIoComplete(int status);
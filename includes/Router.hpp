@@ -10,6 +10,9 @@
 #ifndef INCLUDES_SERVER_ROUTER_HPP_
 #define INCLUDES_SERVER_ROUTER_HPP_
 
+#include <fcntl.h>
+
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -17,15 +20,45 @@
 #include "PathResolver.hpp"
 #include "Utils.hpp"
 
+#define GZIP_LEVEL 1         // gzip_comp_level 기본 값
+#define GZIP_MIN_LENGTH 256  // gzip_min_length 기본 값
+
+struct GzipOption {
+  bool is_on;
+  int level;
+  size_t min_length;
+  std::set<std::string> types;  // 압축할 MIME 타입
+
+  GzipOption(void);
+};
+
+struct CacheOption {
+  int expires;                // max-age 초, -1 이면 off
+  std::string cache_control;  // cache_control 디렉티브 값
+  std::string header;         // 미리 작성한 "cache-control: ...\r\n"
+
+  static const CacheOption kOff;  // 캐시 헤더 없음, location 이 없는 결과용
+
+  CacheOption(void);
+  void Render(void);
+};
+
 struct Location {
   bool error;
   bool autoindex;
+  bool autoindex_sort;
+  bool sendfile;
+  bool gzip_static;
+  bool brotli_static;
   uint8_t methods;
+  int root_fd;  // root 디렉토리 fd, 열지 못했으면 AT_FDCWD
   size_t body_max;
   std::string root;
   std::string index;
   std::string upload_path;
   std::string redirect_to;
+  GzipOption gzip;
+  CacheOption cache;
 
   Location(void);
   Location(bool is_error, std::string error_path);
@@ -48,6 +81,9 @@ typedef std::pair<std::string, Location> LocationNode;
 struct LocationRouter {
   typedef std::vector<LocationNode> CgiVector;
 
+  size_t chunk_max;
+  size_t send_budget;
+  bool tcp_nopush;
   Location error;
   CgiVector cgi_vector;
   LocationMap location_map;
@@ -70,15 +106,33 @@ class Router {
  public:
   struct Result {
     bool is_cgi;
+    bool autoindex_sort;
+    bool sendfile;
+    bool gzip_static;
+    bool brotli_static;
     int status;
     uint8_t methods;
+    int root_fd;      // success_path 가 속한 root 디렉토리 fd
+    size_t root_len;  // success_path 중 root_fd 가 가리키는 부분의 길이
     std::string success_path;
     std::string error_path;
     std::string redirect_to;
+    const GzipOption* gzip;  // location 의 gzip 설정, 없으면 NULL
+    const CacheOption* cache;  // location 의 캐시 설정
     CgiEnv cgi_env;
 
     Result(int parse_status)
-        : is_cgi(false), status(parse_status), methods(GET) {}
+        : is_cgi(false),
+          autoindex_sort(true),
+          sendfile(true),
+          gzip_static(false),
+          brotli_static(false),
+          status(parse_status),
+          methods(GET),
+          root_fd(AT_FDCWD),
+          root_len(0),
+          gzip(NULL),
+          cache(&CacheOption::kOff) {}
   };
 
   Router(ServerRouter& server_router);
@@ -97,6 +151,7 @@ class Router {
                   const CgiDiscriminator& kCgiDiscriminator,
                   const ConnectionInfo& kConnectionInfo);
   bool GetHostAddr(ConnectionInfo& connection_info) const;
+  void SetRoot(Result& result, const Location& kLocation);
   void UpdateStatus(Result& result, int status);
 };
 
@@ -0,0 +1,83 @@
+/**
+ * @file StaticResponseCache.hpp
+ * @author ghan, jiskim, yongjule
+ * @brief Memory-budgeted LRU cache of small static responses
+ * @date 2022-11-24
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef INCLUDES_STATICRESPONSECACHE_HPP_
+#define INCLUDES_STATICRESPONSECACHE_HPP_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <ctime>
+#include <list>
+#include <map>
+#include <new>
+#include <string>
+
+#define STATIC_CACHE_FILE_MAX 65536  // 캐시할 파일 최대 크기, 64KB
+#define STATIC_CACHE_BUDGET 16777216  // 캐시 전체 메모리 한도, 16MB
+
+/**
+ * @brief 캐시된 응답, 요청마다 바뀌지 않는 헤더 뒷부분과 content 를 이어 붙인
+ * blob 을 응답 버퍼들이 참조 수로 공유
+ *
+ */
+struct CachedResponse {
+  std::string blob;          // allow ~ 헤더 끝 CRLF + content
+  uint8_t methods;           // allow 헤더를 만든 location 의 허용 method
+  std::string cache_header;  // blob 에 넣은 location 의 cache-control
+  // blob 에 넣은 vary, location 의 gzip / gzip_static / brotli_static 에 따름
+  std::string vary;
+  int gzip_level;  // 압축한 location 의 gzip_comp_level, 압축 안 했으면 0
+  off_t size;
+  time_t mtime;
+  ino_t inode;
+  int refs;  // 캐시 + 응답 버퍼 참조 수
+
+  CachedResponse(void)
+      : methods(0), gzip_level(0), size(0), mtime(0), inode(0), refs(1) {}
+};
+
+class StaticResponseCache {
+ public:
+  StaticResponseCache(void);
+  ~StaticResponseCache(void);
+
+  CachedResponse* Find(const std::string& kPath, uint8_t methods,
+                       const std::string& kCacheHeader,
+                       const std::string& kVary, int gzip_level, off_t size,
+                       time_t mtime, ino_t inode);
+  CachedResponse* Insert(const std::string& kPath, CachedResponse* response);
+  void Release(CachedResponse* response);
+  void Invalidate(const std::string& kPath);
+  void InvalidatePrefix(const std::string& kPrefix);
+  void Clear(void);
+
+ private:
+  typedef std::list<std::string> LruList;  // front 가 가장 최근에 쓰인 경로
+
+  struct Entry {
+    CachedResponse* response;
+    LruList::iterator lru_it;
+  };
+
+  typedef std::map<std::string, Entry> EntryMap;
+
+  EntryMap entries_;
+  LruList lru_;
+  size_t used_;  // 캐시된 blob 크기 합
+
+  StaticResponseCache(const StaticResponseCache& kOrigin);
+  StaticResponseCache& operator=(const StaticResponseCache& kOrigin);
+
+  void Erase(EntryMap::iterator it);
+};
+
+extern StaticResponseCache g_static_response_cache;
+
+#endif  // INCLUDES_STATICRESPONSECACHE_HPP_
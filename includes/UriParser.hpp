@@ -35,7 +35,7 @@ class UriParser {
 
   Result ParseTarget(std::string uri);
   bool ParseHost(std::string& uri);
-  void EncodeAsciiToHex(std::string& path);
+  void EncodeAsciiToHex(const std::string& kPath, std::string& encoded);
   bool DecodeHexToAscii(std::string& uri, const size_t kPos);
   std::string GetFullPath(void);
 
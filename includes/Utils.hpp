@@ -10,6 +10,8 @@
 #ifndef INCLUDES_TYPES_HPP_
 #define INCLUDES_TYPES_HPP_
 
+#include <sys/types.h>
+
 #include <cerrno>
 #include <iostream>
 #include <list>
@@ -17,6 +19,9 @@
 #include <set>
 #include <string>
 
+#include "Fields.hpp"
+#include "MimeMap.hpp"
+
 #define GET 0x01
 #define POST 0x02
 #define DELETE 0x04
@@ -61,14 +66,13 @@ typedef std::set<HostPortPair> HostPortSet;
 struct ServerConfig {
   HostPortMap host_port_map;
   HostPortSet host_port_set;
+  MimeTypeList mime_types;  // types 블록에서 추가한 MIME 타입
 };
 
 // SECTION : GenerateSocket 파싱 구조체 typedef
 typedef std::map<int, HostPortPair> ListenerMap;  // key: fd, value: port
 
 // SECTION : Http request 파싱 구조체
-typedef std::map<std::string, std::list<std::string> > Fields;
-
 struct RequestLine {
   uint8_t method;
   uint8_t version;
@@ -98,17 +102,42 @@ struct ConnectionInfo {
 // SECTION : ResponseManager 가 반환하는 응답 헤더 필드
 typedef std::map<std::string, std::string> ResponseHeaderMap;
 
+// SECTION : 응답 송신 크기
+// 송신 버퍼 여유 공간을 알 수 없을 때의 송신 크기 및 send low watermark 기준
+#define SEND_BUFF_SIZE 32768  // 32KB
+// 한 번의 쓰기 이벤트에서 송신할 최대 바이트 수, config 의 send_budget 로 변경
+#define SEND_BUDGET 1048576  // 1MB
+
 // SECTION : ResponseBufferQueue node
+struct CachedResponse;
+class AutoindexStream;
+
 struct ResponseBuffer {
   enum { kHeader = 0, kContent };
 
   bool is_complete;
+  bool is_streamed;   // 파일을 sendfile 대신 버퍼로 나눠 읽어서 전송
   int cur_buf;
+  int file_fd;             // content 대신 sendfile 로 보낼 파일, 없으면 -1
+  off_t file_offset;       // 파일에서 보낼 시작 위치
+  size_t file_size;        // 파일에서 보낼 길이
+  CachedResponse* cached;  // content 대신 보낼 캐시된 응답, 없으면 NULL
+  // 보낸 content 를 다음 chunk 로 이어서 채울 autoindex, 없으면 NULL
+  AutoindexStream* autoindex_stream;
   size_t offset;
   std::string header;
   std::string content;
 
-  ResponseBuffer(void) : is_complete(false), cur_buf(kHeader), offset(0) {}
+  ResponseBuffer(void)
+      : is_complete(false),
+        is_streamed(false),
+        cur_buf(kHeader),
+        file_fd(-1),
+        file_offset(0),
+        file_size(0),
+        cached(NULL),
+        autoindex_stream(NULL),
+        offset(0) {}
 };
 
 #endif  // INCLUDES_TYPES_HPP_
@@ -41,10 +41,29 @@ class Validator {
   };
 
  private:
-  enum ServerDirective { kListen = 0, kServerName, kError, kRoute, kCgiRoute };
+  enum ServerDirective {
+    kListen = 0,
+    kServerName,
+    kError,
+    kChunkMax,
+    kSendBudget,
+    kTcpNopush,
+    kRoute,
+    kCgiRoute
+  };
 
   enum LocationDirective {
     kAutoindex = 0,
+    kAutoindexSort,
+    kSendfile,
+    kGzipStatic,
+    kBrotliStatic,
+    kGzip,
+    kGzipTypes,
+    kGzipMinLength,
+    kGzipCompLevel,
+    kExpires,
+    kCacheControl,
     kMethods,
     kBodyMax,
     kRoot,
@@ -89,6 +108,9 @@ class Validator {
   const std::string TokenizeRoutePath(ConstIterator_& delim,
                                       ServerDirective is_cgi);
   uint8_t TokenizeMethods(ConstIterator_& delim, ServerDirective is_cgi);
+  std::set<std::string> TokenizeMimeTypes(ConstIterator_& delim);
+  int TokenizeExpires(ConstIterator_& delim);
+  const std::string TokenizeLine(ConstIterator_& delim);
   ConstIterator_ CheckEndOfParameter(ConstIterator_ delim);
   void ValidateRedirectToToken(std::string& redirect_to_token);
 
@@ -103,6 +125,9 @@ class Validator {
                                     RouteKeyMap_& key_map,
                                     ServerDirective is_cgi);
 
+  // types 블록 파싱 및 검증
+  void ValidateTypes(MimeTypeList& mime_types);
+
   // LocationRouter, Location 파싱 및 검증
   HostPortServerPair ValidateLocationRouter(HostPortSet& host_port_set);
   LocationNode ValidateLocation(ConstIterator_& token, ServerDirective is_cgi);
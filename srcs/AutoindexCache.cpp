@@ -0,0 +1,135 @@
+/**
+ * @file AutoindexCache.cpp
+ * @author ghan, jiskim, yongjule
+ * @brief Memory-budgeted LRU cache of rendered autoindex listings
+ * @date 2022-11-27
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "AutoindexCache.hpp"
+
+/**
+ * @brief 빈 캐시 생성
+ *
+ */
+AutoindexCache::AutoindexCache(void) : used_(0) {}
+
+/**
+ * @brief 캐시된 페이지 정리
+ *
+ */
+AutoindexCache::~AutoindexCache(void) { Clear(); }
+
+/**
+ * @brief 디렉토리의 캐시된 autoindex 페이지 복사, 디렉토리 mtime/inode 가
+ * 바뀌었으면 (엔트리 추가/삭제/이름 변경) 캐시에서 제거
+ *
+ * @param kDir 디렉토리 경로
+ * @param mtime 현재 디렉토리 수정 시각
+ * @param inode 현재 디렉토리 inode
+ * @param listing 캐시된 페이지를 복사할 문자열
+ * @return true 캐시된 페이지 사용
+ * @return false 캐시에 없거나 디렉토리가 바뀜
+ */
+bool AutoindexCache::Find(const std::string& kDir, time_t mtime, ino_t inode,
+                          std::string& listing) {
+  EntryMap::iterator it = entries_.find(kDir);
+  if (it == entries_.end()) {
+    return false;
+  }
+  if (it->second.mtime != mtime || it->second.inode != inode) {
+    Erase(it);
+    return false;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+  listing = it->second.listing;
+  return true;
+}
+
+/**
+ * @brief 캐시된 페이지를 만들 때의 디렉토리 mtime/inode 확인, 작업 스레드가
+ * 디렉토리가 그대로면 다시 읽지 않도록 넘겨줌
+ *
+ * @param kDir 디렉토리 경로
+ * @param mtime 캐시된 페이지의 디렉토리 수정 시각을 받을 변수
+ * @param inode 캐시된 페이지의 디렉토리 inode 를 받을 변수
+ * @return true 캐시에 있음
+ * @return false 캐시에 없음
+ */
+bool AutoindexCache::Peek(const std::string& kDir, time_t& mtime,
+                          ino_t& inode) const {
+  EntryMap::const_iterator it = entries_.find(kDir);
+  if (it == entries_.end()) {
+    return false;
+  }
+  mtime = it->second.mtime;
+  inode = it->second.inode;
+  return true;
+}
+
+/**
+ * @brief 새로 만든 autoindex 페이지를 캐시에 추가, 메모리 한도를 넘으면 오래
+ * 쓰이지 않은 페이지부터 제거하고 한도보다 큰 페이지는 캐시하지 않음
+ *
+ * @param kDir 디렉토리 경로
+ * @param mtime 페이지를 만들기 전 디렉토리 수정 시각
+ * @param inode 디렉토리 inode
+ * @param kListing autoindex 페이지
+ */
+void AutoindexCache::Insert(const std::string& kDir, time_t mtime,
+                            ino_t inode, const std::string& kListing) {
+  EntryMap::iterator old_it = entries_.find(kDir);
+  if (old_it != entries_.end()) {
+    Erase(old_it);
+  }
+  if (kListing.size() > AUTOINDEX_CACHE_BUDGET) {
+    return;
+  }
+  while (lru_.empty() == false &&
+         used_ + kListing.size() > AUTOINDEX_CACHE_BUDGET) {
+    Erase(entries_.find(lru_.back()));
+  }
+  lru_.push_front(kDir);
+  Entry& entry = entries_[kDir];
+  entry.listing = kListing;
+  entry.mtime = mtime;
+  entry.inode = inode;
+  entry.lru_it = lru_.begin();
+  used_ += kListing.size();
+}
+
+/**
+ * @brief 경로가 kPrefix 로 시작하는 캐시된 페이지 모두 제거 (디렉토리 변경 시)
+ *
+ * @param kPrefix 디렉토리 경로
+ */
+void AutoindexCache::InvalidatePrefix(const std::string& kPrefix) {
+  EntryMap::iterator it = entries_.lower_bound(kPrefix);
+  while (it != entries_.end() &&
+         it->first.compare(0, kPrefix.size(), kPrefix) == 0) {
+    Erase(it++);
+  }
+}
+
+/**
+ * @brief 모든 캐시된 페이지 제거
+ *
+ */
+void AutoindexCache::Clear(void) {
+  entries_.clear();
+  lru_.clear();
+  used_ = 0;
+}
+
+// SECTION : private
+/**
+ * @brief 캐시 엔트리 제거
+ *
+ * @param it 제거할 엔트리
+ */
+void AutoindexCache::Erase(EntryMap::iterator it) {
+  used_ -= it->second.listing.size();
+  lru_.erase(it->second.lru_it);
+  entries_.erase(it);
+}
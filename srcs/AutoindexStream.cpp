@@ -0,0 +1,140 @@
+/**
+ * @file AutoindexStream.cpp
+ * @author ghan, jiskim, yongjule
+ * @brief Render autoindex entries and stream unsorted listings in chunks
+ * @date 2022-11-28
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "AutoindexStream.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief 작업 스레드가 읽은 엔트리를 정렬하지 않고 읽은 순서대로 보낼 스트림
+ * 생성
+ *
+ * @param names 디렉토리 엔트리 이름, 스트림으로 옮겨지고 비워짐
+ * @param kPath 디렉토리 경로
+ */
+AutoindexStream::AutoindexStream(std::vector<std::string>& names,
+                                 const std::string& kPath)
+    : next_(0), is_done_(false), head_(FormatHead(kPath)) {
+  names_.swap(names);
+}
+
+/**
+ * @brief 스트림 소멸자
+ *
+ */
+AutoindexStream::~AutoindexStream(void) {}
+
+/**
+ * @brief 엔트리를 AUTOINDEX_BATCH 개 까지 chunked transfer-coding 의 chunk
+ * 하나로 작성, 마지막 엔트리까지 작성하면 페이지 끝부분과 last-chunk 까지 작성
+ * 파일 시스템은 건드리지 않으므로 이벤트 루프에서 호출해도 막히지 않음
+ *
+ * @param chunk 작성할 chunk (기존 내용은 지움)
+ */
+void AutoindexStream::Fill(std::string& chunk) {
+  std::string data;
+  data.swap(head_);
+  size_t last = std::min(next_ + AUTOINDEX_BATCH, names_.size());
+  for (; next_ < last; ++next_) {
+    AppendEntry(data, names_[next_]);
+  }
+  if (next_ == names_.size()) {
+    data += AUTOINDEX_TAIL;
+    is_done_ = true;
+  }
+  std::stringstream ss;
+  ss << std::hex << data.size() << CRLF;
+  chunk = ss.str();
+  chunk += data;
+  chunk += CRLF;
+  if (is_done_ == true) {
+    chunk += "0" CRLF CRLF;
+  }
+}
+
+/**
+ * @brief 디렉토리를 끝까지 읽었는지 확인
+ *
+ * @return true
+ * @return false
+ */
+bool AutoindexStream::is_done(void) const { return is_done_; }
+
+/**
+ * @brief autoindex 페이지 앞부분 작성
+ *
+ * @param kPath 디렉토리 경로
+ * @return std::string <pre> 까지의 페이지 앞부분
+ */
+std::string AutoindexStream::FormatHead(const std::string& kPath) {
+  std::string index_of = "Index of " + kPath.substr(1);
+  return "<!DOCTYPE html><html><title>" + index_of + "</title><body><h1>" +
+         index_of + "</h1><hr><pre>\n";
+}
+
+/**
+ * @brief autoindex 에 나열할 엔트리 이름 작성, 디렉토리면 '/' 를 붙이고
+ * 심볼릭 링크나 타입을 모르는 엔트리는 가리키는 파일로 판별
+ *
+ * @param dir_fd 엔트리가 있는 디렉토리 fd
+ * @param kEnt 디렉토리 엔트리
+ * @param name 작성할 엔트리 이름
+ * @return true
+ * @return false stat 실패
+ */
+bool AutoindexStream::ReadEntry(int dir_fd, const dirent* kEnt,
+                                std::string& name) {
+  name = kEnt->d_name;
+  bool is_dir = (kEnt->d_type == DT_DIR);
+  if (kEnt->d_type == DT_LNK || kEnt->d_type == DT_UNKNOWN) {
+    struct stat s_buf;
+    if (fstatat(dir_fd, kEnt->d_name, &s_buf, 0) == -1) {
+      return false;
+    }
+    is_dir = S_ISDIR(s_buf.st_mode);
+  }
+  if (is_dir == true) {
+    name += '/';
+  }
+  return true;
+}
+
+/**
+ * @brief autoindex 엔트리 하나를 html <a> 태그 달아서 이어 붙임
+ *
+ * @param listing 엔트리를 이어 붙일 페이지
+ * @param kName 엔트리 이름 (디렉토리면 '/' 로 끝남)
+ */
+void AutoindexStream::AppendEntry(std::string& listing,
+                                  const std::string& kName) {
+  listing += "<a href='./";
+  UriParser().EncodeAsciiToHex(kName, listing);
+  listing += "'>";
+  listing += kName;
+  listing += "</a>\n";
+}
+
+/**
+ * @brief autoindex 정렬 순서 비교, 디렉토리가 파일보다 앞이고 같은 종류끼리는
+ * 이름 순
+ *
+ * @param kLhs 엔트리 이름
+ * @param kRhs 엔트리 이름
+ * @return true kLhs 가 앞
+ * @return false
+ */
+bool AutoindexStream::IsOrdered(const std::string& kLhs,
+                                const std::string& kRhs) {
+  bool is_lhs_dir = (*kLhs.rbegin() == '/');
+  bool is_rhs_dir = (*kRhs.rbegin() == '/');
+  if (is_lhs_dir != is_rhs_dir) {
+    return is_lhs_dir;
+  }
+  return kLhs < kRhs;
+}
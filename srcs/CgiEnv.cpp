@@ -81,6 +81,8 @@ bool CgiEnv::SetMetaVariables(Request &request, const std::string &kRoot,
                               const std::string &kCgiExt,
                               const ConnectionInfo &kConnectionInfo) {
   ScriptUri script_uri;
+  Fields::const_iterator content_type_it =
+      request.header.find(Fields::kContentType);
   if (ParseScriptUriComponents(script_uri, request.req.path, kRoot, kCgiExt) ==
       false) {
     return false;
@@ -90,8 +92,8 @@ bool CgiEnv::SetMetaVariables(Request &request, const std::string &kRoot,
       "CONTENT_LENGTH=" + ((request.content.size() > 0)
                                ? IntToString(request.content.size())
                                : ""),
-      "CONTENT_TYPE=" + ((request.header.count("content-type") > 0)
-                             ? request.header["content-type"].front()
+      "CONTENT_TYPE=" + ((content_type_it != request.header.end())
+                             ? content_type_it->second.front()
                              : ""),
       "GATEWAY_INTERFACE=CGI/1.1",
       "PATH_INFO=" + script_uri.path_info,
@@ -23,6 +23,7 @@ CgiManager::CgiManager(bool is_keep_alive, ResponseBuffer& response,
       is_header_(true),
       pid_(-1),
       write_offset_(0),
+      content_len_(0),
       response_content_(response.content) {}
 
 /**
@@ -73,14 +74,14 @@ ResponseManager::IoFdPair CgiManager::Execute(void) {
  */
 void CgiManager::DupFds(void) {
   if (dup2(out_fd_[1], STDOUT_FILENO) == -1) {
-    exit(EXIT_FAILURE);
+    _exit(EXIT_FAILURE);
   }
   close(out_fd_[1]);
   close(out_fd_[0]);
   out_fd_[0] = -1;
   out_fd_[1] = -1;
   if (dup2(in_fd_[0], STDIN_FILENO) == -1) {
-    exit(EXIT_FAILURE);
+    _exit(EXIT_FAILURE);
   }
   close(in_fd_[0]);
   close(in_fd_[1]);
@@ -89,71 +90,23 @@ void CgiManager::DupFds(void) {
 }
 
 /**
- * @brief Command line 형태로 query 요청이 왔을때 argv로 파싱
- *
- * @param arg_vector 파싱된 argv를 저장할 vector
- * @param query 요청 query
- */
-void CgiManager::ParseScriptCommandLine(std::vector<std::string>& arg_vector,
-                                        std::string query) {
-  if (*(query.rbegin()) == '+') {
-    return;
-  }
-  query.erase(0, 13);  // QUERY_STRING=
-  if (query.empty() == false && query.find("=") == std::string::npos) {
-    size_t start = 0;
-    for (size_t plus_pos = query.find("+"); plus_pos != std::string::npos;
-         plus_pos = query.find("+", start)) {
-      arg_vector.push_back(query.substr(start, plus_pos - start));
-      start = plus_pos + 1;
-    }
-    if (start < query.size()) {
-      arg_vector.push_back(query.substr(start));
-    }
-  }
-  for (size_t i = 0; i < arg_vector.size(); ++i) {
-    for (size_t k = 0; k < arg_vector[i].size(); ++k) {
-      if (arg_vector[i][k] == '%') {
-        UriParser().DecodeHexToAscii(arg_vector[i], k);
-      }
-    }
-  }
-}
-
-/**
- * @brief CGI 프로세스의 환경변수와 인자 설정 및 스크립트 실행
+ * @brief CGI 프로세스의 작업 디렉토리와 입출력 설정 및 스크립트 실행
+ * 작업 스레드가 malloc lock 을 잡은 채로 fork 될 수 있으므로 메모리 할당 없이
+ * 부모가 준비한 인자만 사용하고 _exit 로 종료
  *
- * @param kSuccessPath CGI 스크립트의 경로
+ * @param kScriptDir CGI 스크립트가 있는 디렉토리
+ * @param kArgv CGI 스크립트 이름과 인자
  * @param kEnv CGI 스크립트 실행에 필요한 환경변수
  */
-void CgiManager::ExecuteScript(const char* kSuccessPath, char* const* kEnv) {
-  // 1. ENAMETOOLONG, 2.ENOMEM(dirname)
-  if (kEnv == NULL) {
-    exit(EXIT_FAILURE);
-  }
-  char* new_cwd = dirname(const_cast<char*>(kSuccessPath));
-  if (new_cwd == NULL || chdir(new_cwd) == -1) {
-    exit(EXIT_FAILURE);
-  }
-  char* script_path = basename(const_cast<char*>(kSuccessPath));
-  if (script_path == NULL) {
-    exit(EXIT_FAILURE);
+void CgiManager::ExecuteScript(const char* kScriptDir, char* const* kArgv,
+                               char* const* kEnv) {
+  if (chdir(kScriptDir) == -1) {
+    _exit(EXIT_FAILURE);
   }
   DupFds();
-  std::vector<std::string> arg_vector;
-  ParseScriptCommandLine(arg_vector, kEnv[6]);
-  const char** kArgv = new (std::nothrow) const char*[arg_vector.size() + 2];
-  if (kArgv == NULL) {
-    exit(EXIT_FAILURE);
-  }
-  memset(kArgv, 0, sizeof(char*) * (arg_vector.size() + 2));
-  kArgv[0] = script_path;
-  for (size_t i = 0; i < arg_vector.size(); ++i) {
-    kArgv[i + 1] = arg_vector[i].c_str();
-  }
   alarm(5);  // CGI script timeout
-  execve(script_path, const_cast<char* const*>(kArgv), kEnv);
-  exit(EXIT_FAILURE);
+  execve(kArgv[0], kArgv, kEnv);
+  _exit(EXIT_FAILURE);
 }
 
 // SECTION : parent
@@ -163,11 +116,27 @@ void CgiManager::ExecuteScript(const char* kSuccessPath, char* const* kEnv) {
  *
  */
 void CgiManager::SetIpc(void) {
-  const char* kPath = router_result_.success_path.c_str();
-  if (CheckFileMode(kPath) == false) {
+  if (CheckFileMode() == false) {
     io_status_ = SetIoComplete(ERROR_START);
     return;
   }
+  // fork 한 자식은 메모리를 할당하지 않도록 exec 할 인자를 미리 준비
+  char* const* kEnv =
+      const_cast<char* const*>(router_result_.cgi_env.get_env());
+  if (kEnv == NULL) {
+    result_.status = 500;
+    io_status_ = SetIoComplete(ERROR_START);
+    return;
+  }
+  const std::string& kPath = router_result_.success_path;
+  size_t slash_pos = kPath.rfind('/');
+  std::string script_dir(kPath, 0, slash_pos + 1);
+  std::vector<std::string> arg_vector(1, kPath.substr(slash_pos + 1));
+  ParseScriptCommandLine(arg_vector, kEnv[6]);
+  std::vector<char*> argv(arg_vector.size() + 1, NULL);
+  for (size_t i = 0; i < arg_vector.size(); ++i) {
+    argv[i] = const_cast<char*>(arg_vector[i].c_str());
+  }
   if (OpenPipes() == false) {
     result_.status = 500;
     io_status_ = SetIoComplete(ERROR_START);
@@ -175,8 +144,7 @@ void CgiManager::SetIpc(void) {
   }
   pid_ = fork();
   if (pid_ == 0) {
-    ExecuteScript(kPath,
-                  const_cast<char* const*>(router_result_.cgi_env.get_env()));
+    ExecuteScript(script_dir.c_str(), &argv[0], kEnv);
   } else if (pid_ > 0) {
     io_status_ = PIPE_WRITE;
   } else {
@@ -185,6 +153,39 @@ void CgiManager::SetIpc(void) {
   }
 }
 
+/**
+ * @brief Command line 형태로 query 요청이 왔을때 argv로 파싱
+ *
+ * @param arg_vector 파싱된 argv를 뒤에 추가할 vector
+ * @param query 요청 query
+ */
+void CgiManager::ParseScriptCommandLine(std::vector<std::string>& arg_vector,
+                                        std::string query) {
+  if (*(query.rbegin()) == '+') {
+    return;
+  }
+  size_t first_arg = arg_vector.size();
+  query.erase(0, 13);  // QUERY_STRING=
+  if (query.empty() == false && query.find("=") == std::string::npos) {
+    size_t start = 0;
+    for (size_t plus_pos = query.find("+"); plus_pos != std::string::npos;
+         plus_pos = query.find("+", start)) {
+      arg_vector.push_back(query.substr(start, plus_pos - start));
+      start = plus_pos + 1;
+    }
+    if (start < query.size()) {
+      arg_vector.push_back(query.substr(start));
+    }
+  }
+  for (size_t i = first_arg; i < arg_vector.size(); ++i) {
+    for (size_t k = 0; k < arg_vector[i].size(); ++k) {
+      if (arg_vector[i][k] == '%') {
+        UriParser().DecodeHexToAscii(arg_vector[i], k);
+      }
+    }
+  }
+}
+
 /**
  * @brief CGI 프로세스와 서버의 통신을 위한 파이프 open, non-block 세팅
  *
@@ -208,15 +209,18 @@ bool CgiManager::OpenPipes(void) {
 }
 
 /**
- * @brief 실행할 CGI 스크립트가 실행가능 한 지 판단하고 불가능하면 에러 설정
+ * @brief 실행할 CGI 스크립트가 실행가능 한 지 root 디렉토리 fd 기준으로 판단하고
+ * 불가능하면 에러 설정
  *
- * @param kPath CGI 스크립트 경로
  * @return true
  * @return false
  */
-bool CgiManager::CheckFileMode(const char* kPath) {
+bool CgiManager::CheckFileMode(void) {
   errno = 0;
-  if (access(kPath, X_OK) == -1) {
+  if (faccessat(router_result_.root_fd,
+                OpenFileCache::GetRelativePath(router_result_.success_path,
+                                               router_result_.root_len),
+                X_OK, 0) == -1) {
     if (errno == ENOENT) {
       result_.status = 404;  // PAGE NOT FOUND
     } else if (errno == EACCES) {
@@ -305,6 +309,9 @@ bool CgiManager::ReceiveCgiHeaderFields(ResponseHeaderMap& header,
  * @return false
  */
 bool CgiManager::ReceiveCgiResponse(ResponseHeaderMap& header) {
+  if (is_header_ == false) {
+    return ReceiveCgiContent();
+  }
   char buf[PIPE_BUF_SIZE + 1];
   memset(buf, 0, PIPE_BUF_SIZE + 1);
 
@@ -315,28 +322,51 @@ bool CgiManager::ReceiveCgiResponse(ResponseHeaderMap& header) {
   if (read_size < PIPE_BUF_SIZE) {
     io_status_ = SetIoComplete(IO_COMPLETE);
   }
-  if (is_header_ == true) {
-    header_read_buf_.append(buf, read_size);
-    if (header_read_buf_.size() > HEADER_MAX) {
-      return false;
-    }
-    size_t header_end = header_read_buf_.find(CRLF CRLF);
-    if (header_end != std::string::npos) {
-      if (ReceiveCgiHeaderFields(header, header_end + 2) == false) {
-        return false;
-      }
-      is_header_ = false;
-      response_content_.append(header_read_buf_, header_end + 4);
-    }
-  } else {
-    response_content_.append(buf, read_size);
-    if (response_content_.size() > CONTENT_MAX) {
+  header_read_buf_.append(buf, read_size);
+  if (header_read_buf_.size() > HEADER_MAX) {
+    return false;
+  }
+  size_t header_end = header_read_buf_.find(CRLF CRLF);
+  if (header_end != std::string::npos) {
+    if (ReceiveCgiHeaderFields(header, header_end + 2) == false) {
       return false;
     }
+    is_header_ = false;
+    response_content_.append(header_read_buf_, header_end + 4);
+    content_len_ = response_content_.size();
+    std::string().swap(header_read_buf_);
   }
   return true;
 }
 
+/**
+ * @brief CGI 응답 헤더 이후의 body 를 중간 버퍼를 거치지 않고 response
+ * content 뒤에 바로 읽기, 버퍼는 두 배씩 늘려 0 으로 채우는 비용을 읽을 때
+ * 마다가 아니라 늘릴 때만 내고 실제 길이는 content_len_ 으로 관리
+ * 다 읽으면 실제 길이로 줄임
+ *
+ * @return true
+ * @return false
+ */
+bool CgiManager::ReceiveCgiContent(void) {
+  if (response_content_.size() < content_len_ + PIPE_BUF_SIZE) {
+    response_content_.resize(std::max(response_content_.size() * 2,
+                                      content_len_ + PIPE_BUF_SIZE));
+  }
+  ssize_t read_size =
+      read(out_fd_[0], &response_content_[content_len_], PIPE_BUF_SIZE);
+  if (read_size < 0) {
+    response_content_.resize(content_len_);
+    return false;
+  }
+  content_len_ += read_size;
+  if (read_size < PIPE_BUF_SIZE) {
+    response_content_.resize(content_len_);
+    io_status_ = SetIoComplete(IO_COMPLETE);
+  }
+  return (content_len_ <= CONTENT_MAX);
+}
+
 /**
  * @brief CGI 응답 종류 판별 (Document/Local Redirection/Client Redirection)
  *
@@ -17,7 +17,11 @@ Connection::Connection(void)
     : fd_(-1),
       connection_status_(KEEP_ALIVE),
       send_status_(KEEP_SENDING),
-      buffer_(BUFFER_SIZE, 0),
+      send_budget_(SEND_BUDGET),
+      tcp_nopush_(false),
+      is_corked_(false),
+      buffer_offset_(0),
+      stream_pos_(0),
       router_(NULL) {}
 
 /**
@@ -34,7 +38,8 @@ Connection::~Connection(void) {
 }
 
 /**
- * @brief Connection 객체 재설정
+ * @brief Connection 객체 재설정, 다음 요청이 있으면 버퍼의 남은 데이터를
+ * 복사 없이 다음 파싱에서 이어서 사용
  *
  * @param does_next_req_exist 다음 요청 존재 여부
  */
@@ -42,10 +47,10 @@ void Connection::Reset(bool does_next_req_exist) {
   if (does_next_req_exist == true) {
     connection_status_ = NEXT_REQUEST_EXISTS;
     parser_.Clear();
-    buffer_.erase();
   } else {
     parser_.Reset();
-    buffer_.assign(BUFFER_SIZE, 0);
+    buffer_.clear();
+    buffer_offset_ = 0;
   }
 }
 
@@ -61,15 +66,24 @@ void Connection::Clear(void) {
   connection_status_ = KEEP_ALIVE;
   send_status_ = KEEP_SENDING;
   parser_.Reset();
-  buffer_.assign(BUFFER_SIZE, 0);
+  buffer_.clear();
+  buffer_offset_ = 0;
   client_addr_.clear();
   if (router_ != NULL) {
     delete router_;
     router_ = NULL;
   }
-  while (response_queue_.empty() == false) {
-    response_queue_.pop();
+  for (ResponseQueue::iterator it = response_queue_.begin();
+       it != response_queue_.end(); ++it) {
+    g_open_file_cache.Release(it->file_fd);
+    g_static_response_cache.Release(it->cached);
+    delete it->autoindex_stream;
   }
+  response_queue_.clear();
+  std::string().swap(stream_buf_);
+  send_budget_ = SEND_BUDGET;
+  tcp_nopush_ = false;
+  is_corked_ = false;
   response_manager_map_.Clear();
 }
 
@@ -82,16 +96,17 @@ ResponseManager::IoFdPair Connection::HandleRequest(void) {
   if (connection_status_ == CLOSE) {
     return SetConnectionError<ResponseManager::IoFdPair>("");
   }
-  if (connection_status_ != NEXT_REQUEST_EXISTS) {
+  if (HasPipelinedRequest() == false) {
     if (Receive() < 0) {
       return SetConnectionError<ResponseManager::IoFdPair>(
           "Connection : recv failed");
     }
   }
-  int req_status = parser_.Parse(buffer_);
+  int req_status = parser_.Parse(buffer_, buffer_offset_);
   if (req_status < HttpParser::kComplete) {
     connection_status_ = KEEP_READING;
-    buffer_.assign(BUFFER_SIZE, 0);
+    buffer_.clear();
+    buffer_offset_ = 0;
     return ResponseManager::IoFdPair();
   }
   HttpParser::Result req_data = parser_.get_result();
@@ -99,7 +114,7 @@ ResponseManager::IoFdPair Connection::HandleRequest(void) {
   PRINT_REQ_LOG(request.req);
   Router::Result location_data = router_->Route(
       req_data.status, request, ConnectionInfo(host_port_, client_addr_));
-  response_queue_.push(ResponseBuffer());
+  response_queue_.push_back(ResponseBuffer());
   ResponseManager* response_manager =
       GenerateResponseManager((req_status == HttpParser::kComplete), request,
                               location_data, response_queue_.back());
@@ -110,7 +125,7 @@ ResponseManager::IoFdPair Connection::HandleRequest(void) {
   ResponseManager::IoFdPair io_fds = response_manager->Execute();
   DetermineIoComplete(io_fds, response_manager);
   send_status_ = KEEP_SENDING;
-  Reset(connection_status_ == KEEP_ALIVE && parser_.DoesNextReqExist() == true);
+  Reset(connection_status_ == KEEP_ALIVE && HasPipelinedRequest() == true);
   return io_fds;
 }
 
@@ -139,33 +154,46 @@ ResponseManager::IoFdPair Connection::ExecuteMethod(int event_fd) {
 }
 
 /**
- * @brief Response 를 FIFO 로 전송
+ * @brief Response 를 FIFO 로 전송, 준비된 응답이 여러 개면 writev 한 번으로
+ * 모아서 전송하고 파일 body 는 sendfile 로 전송
+ * 첫 writev 는 송신 버퍼 여유 공간 만큼, 이후 송신 버퍼가 찰 때 까지 (EAGAIN)
+ * 반복하되 한 번의 이벤트에서 send_budget_ 을 넘지 않도록 제한
+ * tcp_nopush 가 켜져 있으면 응답을 다 보낼 때 까지 소켓을 막아 꽉 찬 segment
+ * 로만 전송
  *
+ * @param send_space 송신 버퍼 여유 공간 (EVFILT_WRITE 의 data), 모르면 0
  */
-void Connection::Send(void) {
+void Connection::Send(size_t send_space) {
   if (response_queue_.empty() == true) {
     return SetConnectionError<void>("");
   }
-  ResponseBuffer& response = response_queue_.front();
-  struct iovec iovec[2];
-  size_t iov_cnt = SetIov(iovec, response);
-  ssize_t sent_bytes = writev(fd_, iovec, iov_cnt);
-  if (sent_bytes < 0) {
-    return SetConnectionError<void>("writev error :" +
-                                    std::string(strerror(errno)));
+  if (tcp_nopush_ == true && is_corked_ == false) {
+    SetNoPush(true);
   }
-  response.offset += sent_bytes;
-  if (response.cur_buf == ResponseBuffer::kHeader &&
-      response.offset >= response.header.size()) {
-    response.cur_buf = ResponseBuffer::kContent;
-  }
-  send_status_ = KEEP_SENDING;
-  if (response.offset >= response.header.size() + response.content.size()) {
-    response_queue_.pop();
-    send_status_ = SEND_NEXT;
-    if (response_queue_.empty()) {
-      send_status_ = SEND_FINISHED;
+  size_t budget = send_budget_;
+  size_t send_max =
+      std::min((send_space > 0) ? send_space : SEND_BUFF_SIZE, budget);
+  while (budget > 0 && IsResponseBufferReady() == true) {
+    ssize_t sent_bytes = SendBuffers(send_max);
+    if (sent_bytes < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      return SetConnectionError<void>("send error :" +
+                                      std::string(strerror(errno)));
+    }
+    UpdateSentResponses(sent_bytes);
+    if (connection_status_ == CONNECTION_ERROR) {
+      return;
     }
+    if (static_cast<size_t>(sent_bytes) < send_max) {
+      break;  // 송신 버퍼가 가득 참
+    }
+    budget -= sent_bytes;
+    send_max = budget;
+  }
+  if (is_corked_ == true && send_status_ != KEEP_SENDING) {
+    SetNoPush(false);  // 응답이 끝났으면 남은 부분 segment 전송
   }
 }
 
@@ -183,6 +211,9 @@ void Connection::SetAttributes(const int kFd, const std::string& kClientAddr,
   fd_ = kFd;
   client_addr_ = kClientAddr;
   host_port_ = kHostPortPair;
+  parser_.set_chunk_max(server_router.default_server.chunk_max);
+  send_budget_ = server_router.default_server.send_budget;
+  tcp_nopush_ = server_router.default_server.tcp_nopush;
   router_ = new (std::nothrow) Router(server_router);
   if (router_ == NULL) {
     SetConnectionError<void>("Connection : Router memory allocation failure");
@@ -202,6 +233,39 @@ bool Connection::IsResponseBufferReady(void) const {
   return response_queue_.front().is_complete;
 }
 
+/**
+ * @brief 버퍼에 아직 파싱하지 않은 파이프라인 된 요청이 남아있는지 확인
+ *
+ * @return true
+ * @return false
+ */
+bool Connection::HasPipelinedRequest(void) const {
+  return (buffer_offset_ < buffer_.size());
+}
+
+/**
+ * @brief 전송 대기 중인 응답 수가 최대치에 도달했는지 확인
+ *
+ * @return true
+ * @return false
+ */
+bool Connection::IsResponseQueueFull(void) const {
+  return (response_queue_.size() >= RESPONSE_QUEUE_MAX);
+}
+
+/**
+ * @brief 이번 이벤트에서 버퍼에 남은 파이프라인 요청을 이어서 처리할지 확인,
+ * 한 이벤트에서 PIPELINE_REQUEST_MAX 개 까지 처리하고 응답 큐가 가득 차면 멈춤
+ *
+ * @param handled_count 이번 이벤트에서 처리한 요청 수
+ * @return true
+ * @return false
+ */
+bool Connection::CanHandleNextRequest(int handled_count) const {
+  return (handled_count < PIPELINE_REQUEST_MAX &&
+          HasPipelinedRequest() == true && IsResponseQueueFull() == false);
+}
+
 /**
  * @brief 현재 처리중인 요청과 큐에 있는 요청이 동일한지 확인
  *
@@ -240,10 +304,10 @@ int Connection::get_fd(void) const { return fd_; }
  * @return recv_byte 한 회 수신한 바이트 수
  */
 ssize_t Connection::Receive(void) {
+  buffer_.resize(BUFFER_SIZE);
+  buffer_offset_ = 0;
   ssize_t recv_byte = recv(fd_, &buffer_[0], BUFFER_SIZE, 0);
-  if (recv_byte <= BUFFER_SIZE && recv_byte != -1) {
-    buffer_.erase(recv_byte);
-  }
+  buffer_.resize((recv_byte > 0) ? recv_byte : 0);
   return recv_byte;
 }
 
@@ -342,40 +406,224 @@ int Connection::ValidateLocalRedirPath(std::string& path, RequestLine& req) {
 }
 
 /**
- * @brief writev 호출 전 송신할 버퍼 offset 맞춰서 iovec 구조체에 설정
+ * @brief writev 호출 전 큐의 준비된 응답들을 순서대로 send_max 바이트까지
+ * iovec 구조체에 설정, 파일 body 를 가진 응답을 만나면 그 헤더까지만 설정
  *
- * @param iov 외부에서 선언 된 iovec 구조체 배열
- * @param res 처리 중인 요청의 Responsebuffer 구조체
+ * @param iov 외부에서 선언 된 iovec 구조체 배열 (IOV_MAX 크기)
+ * @param send_max 한 번에 송신할 최대 바이트 수
+ * @param iov_len iovec 에 설정된 총 바이트 수
+ * @param file_res 이어서 sendfile 로 보낼 응답, 없으면 NULL
  * @return size_t iovec 배열 크기
  */
-size_t Connection::SetIov(struct iovec* iov, ResponseBuffer& res) {
-  std::string& header = res.header;
-  std::string& content = res.content;
-  size_t offset = res.offset;
-  size_t cnt = (res.cur_buf == ResponseBuffer::kHeader &&
-                header.size() < SEND_BUFF_SIZE + offset)
-                   ? 2
-                   : 1;
-  if (res.cur_buf == ResponseBuffer::kHeader) {
-    iov[0].iov_base = &header[0] + offset;
-    iov[0].iov_len = (header.size() < SEND_BUFF_SIZE + offset)
-                         ? header.size() - offset
-                         : SEND_BUFF_SIZE;
-    if (cnt == 2) {
-      iov[1].iov_base = &content[0];
-      iov[1].iov_len = (content.size() + iov[0].iov_len < SEND_BUFF_SIZE)
-                           ? content.size()
-                           : SEND_BUFF_SIZE - iov[0].iov_len;
+size_t Connection::SetIov(struct iovec* iov, size_t send_max, size_t& iov_len,
+                          ResponseBuffer*& file_res) {
+  size_t cnt = 0;
+  iov_len = 0;
+  file_res = NULL;
+  for (ResponseQueue::iterator it = response_queue_.begin();
+       it != response_queue_.end() && it->is_complete == true &&
+       cnt + 2 <= IOV_MAX && iov_len < send_max;
+       ++it) {
+    std::string& header = it->header;
+    std::string& content =
+        (it->cached != NULL) ? it->cached->blob : it->content;
+    if (it->offset < header.size()) {
+      iov[cnt].iov_base = &header[0] + it->offset;
+      iov[cnt].iov_len =
+          std::min(header.size() - it->offset, send_max - iov_len);
+      iov_len += iov[cnt++].iov_len;
+    }
+    size_t content_offset =
+        (it->offset < header.size()) ? 0 : it->offset - header.size();
+    if (iov_len < send_max && content_offset < content.size()) {
+      iov[cnt].iov_base = &content[0] + content_offset;
+      iov[cnt].iov_len =
+          std::min(content.size() - content_offset, send_max - iov_len);
+      iov_len += iov[cnt++].iov_len;
+    }
+    if (it->file_fd != -1) {
+      file_res = &(*it);
+      break;
+    }
+    if (it->autoindex_stream != NULL &&
+        it->autoindex_stream->is_done() == false) {
+      break;  // 다음 chunk 를 채운 후 이어서 전송
     }
-  } else {
-    iov[0].iov_base = &content[0] + (offset - header.size());
-    size_t total_len = header.size() + content.size();
-    iov[0].iov_len = (total_len < SEND_BUFF_SIZE + offset) ? total_len - offset
-                                                           : SEND_BUFF_SIZE;
   }
   return cnt;
 }
 
+/**
+ * @brief 준비된 응답들을 한 번의 시스템 콜로 송신, 파일 body 는 sendfile 로
+ * 유저 영역 복사 없이 전송하고 sendfile 을 쓰지 않는 파일은 STREAM_WINDOW_SIZE
+ * 만큼씩 읽어 소켓이 비워갈 때마다 다시 채우며 전송
+ *
+ * @param send_max 한 번에 송신할 최대 바이트 수
+ * @return ssize_t 송신한 바이트 수, 실패 시 -1
+ */
+ssize_t Connection::SendBuffers(size_t send_max) {
+  struct iovec iov[IOV_MAX];
+  size_t iov_len;
+  ResponseBuffer* file_res;
+  size_t iov_cnt = SetIov(iov, send_max, iov_len, file_res);
+  if (file_res == NULL || iov_len >= send_max) {
+    return writev(fd_, iov, iov_cnt);
+  }
+  size_t head_len = file_res->header.size() + file_res->content.size();
+  size_t body_sent =
+      (file_res->offset > head_len) ? file_res->offset - head_len : 0;
+  off_t file_pos = file_res->file_offset + body_sent;
+  size_t body_len =
+      std::min(file_res->file_size - body_sent, send_max - iov_len);
+  if (file_res->is_streamed == false) {
+    ssize_t sent_bytes =
+        SendFile(*file_res, file_pos, body_len, iov, iov_cnt, iov_len);
+    if (sent_bytes >= 0 || (errno != ENOTSUP && errno != EOPNOTSUPP)) {
+      return sent_bytes;
+    }
+    file_res->is_streamed = true;  // sendfile 을 지원하지 않는 파일
+  }
+  if (FillStreamWindow(file_res->file_fd, file_pos) == false) {
+    return -1;
+  }
+  size_t window_offset = file_pos - stream_pos_;
+  iov[iov_cnt].iov_base = &stream_buf_[0] + window_offset;
+  iov[iov_cnt].iov_len =
+      std::min(body_len, stream_buf_.size() - window_offset);
+  return writev(fd_, iov, iov_cnt + 1);
+}
+
+/**
+ * @brief 앞선 응답들의 헤더를 sf_hdtr 로 붙여 파일 body 를 sendfile 로 전송
+ *
+ * @param res 파일 body 를 가진 응답
+ * @param file_pos 보낼 파일 위치
+ * @param body_len 보낼 파일 길이
+ * @param iov 앞선 응답들의 iovec 배열
+ * @param iov_cnt iovec 배열 크기
+ * @param iov_len iovec 에 설정된 총 바이트 수
+ * @return ssize_t 송신한 바이트 수, 실패 시 -1
+ */
+ssize_t Connection::SendFile(ResponseBuffer& res, off_t file_pos,
+                             size_t body_len, struct iovec* iov,
+                             size_t iov_cnt, size_t iov_len) {
+  off_t len = iov_len + body_len;
+  struct sf_hdtr hdtr;
+  hdtr.headers = iov;
+  hdtr.hdr_cnt = iov_cnt;
+  hdtr.trailers = NULL;
+  hdtr.trl_cnt = 0;
+  if (sendfile(res.file_fd, fd_, file_pos, &len, (iov_cnt > 0) ? &hdtr : NULL,
+               0) == -1 &&
+      len == 0) {
+    return -1;
+  }
+  if (len == 0) {
+    errno = EIO;  // 파일이 fstat 이후 줄어듦
+    return -1;
+  }
+  return len;
+}
+
+/**
+ * @brief 보낼 파일 위치가 stream_buf_ 에 없으면 그 위치부터
+ * STREAM_WINDOW_SIZE 만큼 다시 읽어서 채우고, 다음 window 는 커널이 미리
+ * 읽어 두도록 요청
+ *
+ * @param file_fd 전송 중인 파일 fd
+ * @param file_pos 보낼 파일 위치
+ * @return true
+ * @return false
+ */
+bool Connection::FillStreamWindow(int file_fd, off_t file_pos) {
+  if (stream_pos_ <= file_pos &&
+      file_pos < stream_pos_ + static_cast<off_t>(stream_buf_.size())) {
+    return true;
+  }
+  stream_buf_.resize(STREAM_WINDOW_SIZE);
+  ssize_t read_bytes = OpenFileCache::ReadFull(file_fd, &stream_buf_[0],
+                                               STREAM_WINDOW_SIZE, file_pos);
+  if (read_bytes <= 0) {
+    stream_buf_.clear();
+    if (read_bytes == 0) {
+      errno = EIO;  // 파일이 fstat 이후 줄어듦
+    }
+    return false;
+  }
+  stream_buf_.resize(read_bytes);
+  stream_pos_ = file_pos;
+  if (read_bytes == STREAM_WINDOW_SIZE) {
+    OpenFileCache::AdviseRead(file_fd, file_pos + read_bytes,
+                              STREAM_WINDOW_SIZE);
+  }
+  return true;
+}
+
+/**
+ * @brief 다 보낸 autoindex chunk 자리에 이어지는 엔트리들의 다음 chunk 를 채움
+ *
+ * @param response 정렬하지 않는 autoindex 응답
+ */
+void Connection::FillAutoindexChunk(ResponseBuffer& response) {
+  response.offset = response.header.size();
+  response.autoindex_stream->Fill(response.content);
+}
+
+/**
+ * @brief 소켓의 TCP_NOPUSH 설정, 해제하면 막아둔 마지막 부분 segment 가 전송됨
+ *
+ * @param is_corked 설정 여부
+ */
+void Connection::SetNoPush(bool is_corked) {
+  int opt = is_corked;
+  if (setsockopt(fd_, IPPROTO_TCP, TCP_NOPUSH, &opt, sizeof(opt)) == -1) {
+    PRINT_ERROR("Connection : setting TCP_NOPUSH failed : " << strerror(errno));
+    tcp_nopush_ = false;
+    return;
+  }
+  is_corked_ = is_corked;
+}
+
+/**
+ * @brief 송신한 바이트 수 만큼 큐의 응답들의 offset 갱신, 다 보낸 응답은 제거
+ *
+ * @param sent_bytes writev 로 송신한 바이트 수
+ */
+void Connection::UpdateSentResponses(size_t sent_bytes) {
+  send_status_ = KEEP_SENDING;
+  while (response_queue_.empty() == false &&
+         response_queue_.front().is_complete == true) {
+    ResponseBuffer& response = response_queue_.front();
+    size_t total_len =
+        response.header.size() + response.file_size +
+        ((response.cached != NULL) ? response.cached->blob.size()
+                                   : response.content.size());
+    size_t len = std::min(sent_bytes, total_len - response.offset);
+    response.offset += len;
+    sent_bytes -= len;
+    if (response.cur_buf == ResponseBuffer::kHeader &&
+        response.offset >= response.header.size()) {
+      response.cur_buf = ResponseBuffer::kContent;
+    }
+    if (response.offset < total_len) {
+      return;
+    }
+    if (response.autoindex_stream != NULL &&
+        response.autoindex_stream->is_done() == false) {
+      return FillAutoindexChunk(response);
+    }
+    if (response.is_streamed == true) {
+      std::string().swap(stream_buf_);
+    }
+    g_open_file_cache.Release(response.file_fd);
+    g_static_response_cache.Release(response.cached);
+    delete response.autoindex_stream;
+    response_queue_.pop_front();
+    send_status_ =
+        (response_queue_.empty() == true) ? SEND_FINISHED : SEND_NEXT;
+  }
+}
+
 /**
  * @brief connection_status_ CONNECTION 에러로 설정, 에러 메시지 출력
  *
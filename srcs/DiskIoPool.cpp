@@ -0,0 +1,146 @@
+/**
+ * @file DiskIoPool.cpp
+ * @author ghan, jiskim, yongjule
+ * @brief Worker thread pool for blocking filesystem calls
+ * @date 2022-12-05
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "DiskIoPool.hpp"
+
+/**
+ * @brief DiskIoPool 객체 생성, 스레드는 Start 에서 생성
+ *
+ */
+DiskIoPool::DiskIoPool(void) : thread_count_(0) {
+  pthread_mutex_init(&mutex_, NULL);
+  pthread_cond_init(&cond_, NULL);
+}
+
+/**
+ * @brief DiskIoPool 객체 소멸, 작업 스레드는 detach 되어 있으므로 프로세스와
+ * 함께 종료 (CGI 자식 프로세스의 exit 에서 없는 스레드를 기다리지 않도록 join
+ * 하지 않음)
+ *
+ */
+DiskIoPool::~DiskIoPool(void) {}
+
+/**
+ * @brief 작업 스레드 생성, 하나도 만들지 못하면 Submit 이 실패하고 호출한 쪽이
+ * 이벤트 루프에서 직접 실행
+ *
+ * @return true
+ * @return false
+ */
+bool DiskIoPool::Start(void) {
+  for (; thread_count_ < DISK_IO_THREADS; ++thread_count_) {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, Work, this) != 0) {
+      break;
+    }
+    pthread_detach(thread);
+  }
+  return (thread_count_ > 0);
+}
+
+/**
+ * @brief 작업을 큐에 넣고 완료 알림을 받을 pipe 의 읽기 쪽 반환, 작업이 끝나면
+ * 읽기 쪽에 이벤트가 발생
+ *
+ * @param task new 로 할당한 작업
+ * @return int 완료 알림 fd, 스레드나 pipe 를 만들 수 없으면 -1
+ */
+int DiskIoPool::Submit(DiskTask* task) {
+  int fds[2];
+  if (thread_count_ == 0 || pipe(fds) == -1) {
+    return -1;
+  }
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+  fcntl(fds[0], F_SETFL, O_NONBLOCK);
+  task->done_fd = fds[1];
+  pthread_mutex_lock(&mutex_);
+  ++task->refs;  // 작업 스레드의 참조
+  queue_.push_back(task);
+  pthread_cond_signal(&cond_);
+  pthread_mutex_unlock(&mutex_);
+  return fds[0];
+}
+
+/**
+ * @brief 작업이 끝났는지 확인, 끝났으면 작업 스레드가 쓴 결과를 읽어도 안전
+ *
+ * @param task 확인할 작업
+ * @return true
+ * @return false
+ */
+bool DiskIoPool::IsDone(DiskTask* task) {
+  pthread_mutex_lock(&mutex_);
+  bool is_done = task->is_done;
+  pthread_mutex_unlock(&mutex_);
+  return is_done;
+}
+
+/**
+ * @brief 작업 참조 반납, 더 참조하는 곳이 없으면 해제
+ *
+ * @param task 반납할 작업
+ */
+void DiskIoPool::Release(DiskTask* task) {
+  pthread_mutex_lock(&mutex_);
+  bool is_unused = (--task->refs == 0);
+  pthread_mutex_unlock(&mutex_);
+  if (is_unused == true) {
+    delete task;
+  }
+}
+
+// SECTION : private
+/**
+ * @brief 작업 스레드 루프, 큐에서 꺼낸 작업을 실행하고 완료 알림
+ *
+ * @param pool 작업을 꺼낼 DiskIoPool
+ * @return void* NULL
+ */
+void* DiskIoPool::Work(void* pool) {
+  DiskIoPool* self = static_cast<DiskIoPool*>(pool);
+  while (true) {
+    DiskTask* task = self->Pop();
+    task->routine(*task);
+    self->Complete(task);
+  }
+  return NULL;
+}
+
+/**
+ * @brief 큐에 작업이 들어올 때 까지 기다렸다가 꺼냄
+ *
+ * @return DiskTask* 실행할 작업
+ */
+DiskTask* DiskIoPool::Pop(void) {
+  pthread_mutex_lock(&mutex_);
+  while (queue_.empty() == true) {
+    pthread_cond_wait(&cond_, &mutex_);
+  }
+  DiskTask* task = queue_.front();
+  queue_.pop_front();
+  pthread_mutex_unlock(&mutex_);
+  return task;
+}
+
+/**
+ * @brief 작업 완료 표시 후 pipe 로 이벤트 루프에 알리고 작업 스레드의 참조
+ * 반납, 요청한 쪽이 이미 pipe 를 닫았으면 쓰기가 실패해도 무시 (SIGPIPE 무시)
+ *
+ * @param task 끝난 작업
+ */
+void DiskIoPool::Complete(DiskTask* task) {
+  pthread_mutex_lock(&mutex_);
+  task->is_done = true;
+  pthread_mutex_unlock(&mutex_);
+  char done = 1;
+  write(task->done_fd, &done, 1);
+  close(task->done_fd);
+  Release(task);
+}
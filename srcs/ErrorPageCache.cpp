@@ -0,0 +1,147 @@
+/**
+ * @file ErrorPageCache.cpp
+ * @author ghan, jiskim, yongjule
+ * @brief Error pages loaded at startup and pre-rendered default error bodies
+ * @date 2022-11-29
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "ErrorPageCache.hpp"
+
+/**
+ * @brief 로드된 에러 페이지가 없는 캐시 생성
+ *
+ */
+ErrorPageCache::ErrorPageCache(void) {}
+
+/**
+ * @brief 모든 상태 코드의 기본 에러 페이지 body 를 미리 작성
+ *
+ */
+void ErrorPageCache::RenderDefaultBodies(void) {
+  for (StatusMap::const_iterator it = g_status_map.begin();
+       it != g_status_map.end(); ++it) {
+    if (it->first >= 400) {
+      default_bodies_[it->first] = RenderDefaultBody(it->first);
+    }
+  }
+}
+
+/**
+ * @brief 에러 페이지를 메모리에 로드, 이후 에러 응답은 파일을 읽지 않음
+ *
+ * @param kPath 에러 페이지 경로
+ */
+void ErrorPageCache::Load(const std::string& kPath) {
+  if (pages_.count(kPath) == 0) {
+    ReadPage(kPath, pages_[kPath]);
+  }
+}
+
+/**
+ * @brief 로드된 에러 페이지가 바뀌었으면 다시 로드
+ *
+ * @param kPath 변경된 파일 경로
+ */
+void ErrorPageCache::Reload(const std::string& kPath) {
+  PageMap::iterator it = pages_.find(kPath);
+  if (it != pages_.end()) {
+    ReadPage(kPath, it->second);
+  }
+}
+
+/**
+ * @brief 경로가 kPrefix 로 시작하는 로드된 에러 페이지 모두 다시 로드
+ * (디렉토리 변경 시)
+ *
+ * @param kPrefix 디렉토리 경로
+ */
+void ErrorPageCache::ReloadPrefix(const std::string& kPrefix) {
+  for (PageMap::iterator it = pages_.lower_bound(kPrefix);
+       it != pages_.end() && it->first.compare(0, kPrefix.size(), kPrefix) == 0;
+       ++it) {
+    ReadPage(it->first, it->second);
+  }
+}
+
+/**
+ * @brief 로드된 에러 페이지 반환
+ *
+ * @param kPath 에러 페이지 경로
+ * @return const ErrorPageCache::Page* 로드된 페이지, 없으면 NULL
+ */
+const ErrorPageCache::Page* ErrorPageCache::Find(
+    const std::string& kPath) const {
+  PageMap::const_iterator it = pages_.find(kPath);
+  return (it != pages_.end()) ? &it->second : NULL;
+}
+
+/**
+ * @brief 상태 코드의 미리 작성된 기본 에러 페이지 body 반환
+ *
+ * @param status 응답 상태 코드
+ * @return const std::string& 기본 에러 페이지 body
+ */
+const std::string& ErrorPageCache::GetDefaultBody(int status) {
+  BodyMap::iterator it = default_bodies_.find(status);
+  if (it == default_bodies_.end()) {
+    it = default_bodies_.insert(
+        it, std::make_pair(status, RenderDefaultBody(status)));
+  }
+  return it->second;
+}
+
+// SECTION : private
+/**
+ * @brief 에러 페이지 파일 전체 읽기, 실패 시 errno 저장
+ *
+ * @param kPath 에러 페이지 경로
+ * @param page 읽은 내용을 저장할 페이지
+ */
+void ErrorPageCache::ReadPage(const std::string& kPath, Page& page) {
+  page.err = 0;
+  page.content.clear();
+  struct stat file_stat;
+  int fd = open(kPath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1 || fstat(fd, &file_stat) == -1) {
+    page.err = errno;
+    if (fd != -1) {
+      close(fd);
+    }
+    return;
+  }
+  if (S_ISDIR(file_stat.st_mode)) {
+    page.err = EISDIR;
+    close(fd);
+    return;
+  }
+  page.content.resize(file_stat.st_size);
+  size_t read_len = 0;
+  while (read_len < page.content.size()) {
+    ssize_t read_bytes = read(fd, &page.content[read_len],
+                              page.content.size() - read_len);
+    if (read_bytes <= 0) {
+      if (read_bytes == -1) {
+        page.err = errno;
+      }
+      break;
+    }
+    read_len += read_bytes;
+  }
+  page.content.resize(read_len);
+  close(fd);
+}
+
+/**
+ * @brief 기본 에러 페이지 body 작성
+ *
+ * @param status 응답 상태 코드
+ * @return std::string 기본 에러 페이지 body
+ */
+std::string ErrorPageCache::RenderDefaultBody(int status) {
+  std::stringstream ss;
+  ss << status << " " << g_status_map[status];
+  return "<!DOCTYPE html><title>" + ss.str() + "</title><body><h1>" +
+         ss.str() + "</h1></body></html>";
+}
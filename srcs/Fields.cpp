@@ -0,0 +1,198 @@
+/**
+ * @file Fields.cpp
+ * @author ghan, jiskim, yongjule
+ * @brief Flat HTTP header field table with perfect-hashed known fields
+ * @date 2022-11-22
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "Fields.hpp"
+
+// NOTE : hash = (len * 2 + name[0] + name[len - 1] * 3) % 14
+// 아래 kKnownNames 에 대해 충돌이 없는 perfect hash
+#define FIELD_HASH_SIZE 14
+
+namespace {
+
+const char* const kKnownNames[Fields::kKnownFieldCount] = {
+    "host",
+    "content-length",
+    "transfer-encoding",
+    "connection",
+    "content-type",
+    "expect",
+    "range",
+    "if-range",
+    "if-none-match",
+    "if-modified-since",
+    "accept-encoding"};
+
+const int kHashSlots[FIELD_HASH_SIZE] = {
+    Fields::kUnknown,           // 0
+    Fields::kConnection,        // 1
+    Fields::kAcceptEncoding,    // 2
+    Fields::kUnknown,           // 3
+    Fields::kIfRange,           // 4
+    Fields::kContentLength,     // 5
+    Fields::kContentType,       // 6
+    Fields::kRange,             // 7
+    Fields::kIfModifiedSince,   // 8
+    Fields::kIfNoneMatch,       // 9
+    Fields::kUnknown,           // 10
+    Fields::kTransferEncoding,  // 11
+    Fields::kHost,              // 12
+    Fields::kExpect             // 13
+};
+
+}  // namespace
+
+/**
+ * @brief 빈 헤더 필드 테이블 생성
+ *
+ */
+Fields::Fields(void) {
+  nodes_.reserve(FIELDS_RESERVE);
+  std::fill(known_, known_ + kKnownFieldCount, -1);
+}
+
+/**
+ * @brief 소문자 필드 이름을 perfect hash 로 알려진 필드 Id 로 변환
+ *
+ * @param kName 소문자 필드 이름
+ * @param len 필드 이름 길이
+ * @return Fields::Id 알려진 필드 Id, 없으면 kUnknown
+ */
+Fields::Id Fields::Lookup(const char* kName, size_t len) {
+  if (len == 0) {
+    return kUnknown;
+  }
+  size_t hash = (len * 2 + static_cast<unsigned char>(kName[0]) +
+                 static_cast<unsigned char>(kName[len - 1]) * 3) %
+                FIELD_HASH_SIZE;
+  int id = kHashSlots[hash];
+  if (id == kUnknown || strlen(kKnownNames[id]) != len ||
+      memcmp(kKnownNames[id], kName, len) != 0) {
+    return kUnknown;
+  }
+  return static_cast<Id>(id);
+}
+
+/**
+ * @brief 소문자 필드 이름을 알려진 필드 Id 로 변환
+ *
+ * @param kName 소문자 필드 이름
+ * @return Fields::Id 알려진 필드 Id, 없으면 kUnknown
+ */
+Fields::Id Fields::Lookup(const std::string& kName) {
+  return Lookup(kName.data(), kName.size());
+}
+
+/**
+ * @brief 필드 값 리스트 반환, 없으면 추가 (반환된 참조는 다음 추가 전까지만
+ * 유효)
+ *
+ * @param kName 소문자 필드 이름
+ * @return Fields::Values& 필드 값 리스트
+ */
+Fields::Values& Fields::operator[](const std::string& kName) {
+  Id id = Lookup(kName);
+  iterator it = (id == kUnknown) ? find(kName) : find(id);
+  if (it != nodes_.end()) {
+    return it->second;
+  }
+  if (id != kUnknown) {
+    known_[id] = static_cast<int>(nodes_.size());
+  }
+  nodes_.push_back(Node(kName, Values()));
+  return nodes_.back().second;
+}
+
+/**
+ * @brief 알려진 필드 O(1) 조회
+ *
+ * @param id 알려진 필드 Id
+ * @return Fields::iterator 찾은 필드, 없으면 end()
+ */
+Fields::iterator Fields::find(Id id) {
+  return (id == kUnknown || known_[id] == -1) ? nodes_.end()
+                                              : nodes_.begin() + known_[id];
+}
+
+/**
+ * @brief 알려진 필드 O(1) 조회
+ *
+ * @param id 알려진 필드 Id
+ * @return Fields::const_iterator 찾은 필드, 없으면 end()
+ */
+Fields::const_iterator Fields::find(Id id) const {
+  return (id == kUnknown || known_[id] == -1) ? nodes_.end()
+                                              : nodes_.begin() + known_[id];
+}
+
+/**
+ * @brief 이름으로 필드 조회, 알려진 필드는 O(1), 그 외엔 선형 탐색
+ *
+ * @param kName 소문자 필드 이름
+ * @return Fields::iterator 찾은 필드, 없으면 end()
+ */
+Fields::iterator Fields::find(const std::string& kName) {
+  Id id = Lookup(kName);
+  if (id != kUnknown) {
+    return find(id);
+  }
+  iterator it = nodes_.begin();
+  while (it != nodes_.end() && it->first != kName) {
+    ++it;
+  }
+  return it;
+}
+
+/**
+ * @brief 이름으로 필드 조회, 알려진 필드는 O(1), 그 외엔 선형 탐색
+ *
+ * @param kName 소문자 필드 이름
+ * @return Fields::const_iterator 찾은 필드, 없으면 end()
+ */
+Fields::const_iterator Fields::find(const std::string& kName) const {
+  Id id = Lookup(kName);
+  if (id != kUnknown) {
+    return find(id);
+  }
+  const_iterator it = nodes_.begin();
+  while (it != nodes_.end() && it->first != kName) {
+    ++it;
+  }
+  return it;
+}
+
+/**
+ * @brief 필드 존재 여부 반환
+ *
+ * @param kName 소문자 필드 이름
+ * @return size_t 있으면 1, 없으면 0
+ */
+size_t Fields::count(const std::string& kName) const {
+  return (find(kName) != nodes_.end());
+}
+
+Fields::iterator Fields::begin(void) { return nodes_.begin(); }
+
+Fields::iterator Fields::end(void) { return nodes_.end(); }
+
+Fields::const_iterator Fields::begin(void) const { return nodes_.begin(); }
+
+Fields::const_iterator Fields::end(void) const { return nodes_.end(); }
+
+size_t Fields::size(void) const { return nodes_.size(); }
+
+bool Fields::empty(void) const { return nodes_.empty(); }
+
+/**
+ * @brief 필드 테이블 초기화 (capacity 유지)
+ *
+ */
+void Fields::clear(void) {
+  nodes_.clear();
+  std::fill(known_, known_ + kKnownFieldCount, -1);
+}
@@ -21,26 +21,37 @@ FileManager::FileManager(bool is_keep_alive, ResponseBuffer& response,
                          Router::Result& router_result, Request& request)
     : ResponseManager(is_keep_alive, response, router_result, request),
       in_fd_(-1),
-      out_fd_(-1),
-      write_offset_(0),
+      is_prefetched_(false),
+      is_content_read_(false),
+      disk_task_(NULL),
+      dir_status_(-1),
+      dir_mtime_(0),
+      dir_inode_(0),
+      dir_read_time_(0),
       response_content_(response.content) {}
 
 /**
- * @brief FileManager 소멸자, 사용한 fd 정리
+ * @brief FileManager 소멸자, 사용한 fd 정리 및 작업 스레드의 작업 참조 반납
  *
  */
 FileManager::~FileManager(void) {
   close(in_fd_);
-  close(out_fd_);
+  if (disk_task_ != NULL) {
+    g_disk_io_pool.Release(disk_task_);
+  }
 }
 
 /**
  * @brief FileManager 객체의 상태와 HTTP method에 따라 파일을 읽고 쓰는 작업
- * 수행
+ * 수행, blocking 파일 시스템 작업은 작업 스레드에서 실행하고 완료 알림 fd 를
+ * 반환해 이벤트 루프가 기다리게 함
  *
- * @return ResponseManager::IoFdPair <in_fd, -1> | <out_fd , -1> | <-1, -1>
+ * @return ResponseManager::IoFdPair <in_fd, -1> | <-1, -1>
  */
 ResponseManager::IoFdPair FileManager::Execute(void) {
+  if (disk_task_ != NULL && CollectDiskTask() == false) {
+    return ResponseManager::IoFdPair(in_fd_, -1);  // 아직 작업 중
+  }
   if (router_result_.status >= 400) {
     return GetErrorPage();
   }
@@ -60,177 +71,853 @@ ResponseManager::IoFdPair FileManager::Execute(void) {
     if (io_status_ < ERROR_START) {
       io_status_ = SetIoComplete(ERROR_START);
     }
+    EraseFileHeaders();
     return GetErrorPage();
   }
   if (io_status_ == IO_COMPLETE) {
     return DetermineSuccessFileExt();
   }
-  return (io_status_ == FILE_READ) ? ResponseManager::IoFdPair(in_fd_, -1)
-                                   : ResponseManager::IoFdPair(-1, out_fd_);
+  return ResponseManager::IoFdPair(in_fd_, -1);  // FILE_READ, 작업 완료 대기
 }
 
 // SECTION : private
 /**
- * @brief GET 요청이 왔을 때 파일 타입에 따라 응답 생성
+ * @brief GET 요청이 왔을 때 파일 타입에 따라 응답 생성, 파일은 open file cache
+ * 에서 열린 fd 와 stat 정보를 받아 사용하며 작은 파일은 캐시된 응답으로 전송
+ * 미리 압축된 사이드카 파일이 있으면 원본 대신 전송
+ * 조건부 요청의 validator 가 일치하면 파일을 읽지 않고 304 응답, Range
+ * 요청이면 요청된 범위만 206 응답
+ * gzip 대상 파일은 압축한 응답을 캐시해 두고 전송, Range 요청은 이어 받기가
+ * 되도록 압축하지 않은 파일의 범위로 응답
+ * open file cache 에 없는 파일은 작업 스레드에서 먼저 open, 디렉토리 목록과
+ * 캐시할 파일 내용도 작업 스레드에서 읽음
  *
  */
 void FileManager::Get(void) {
   if (io_status_ == IO_START) {
-    CheckFileMode();
-    if (result_.status >= 400 || response_content_.empty() == false) {
+    if (PrefetchFiles() == true) {
+      return;  // 작업 스레드에서 open 중
+    }
+    EraseFileHeaders();  // 작업 스레드를 기다린 후 다시 실행하면 새로 설정
+    OpenFileCache::Info info =
+        g_open_file_cache.Open(router_result_.success_path,
+                               router_result_.root_fd, router_result_.root_len);
+    CheckFileMode(info);
+    if (result_.status >= 400 || info.is_dir == true) {
+      g_open_file_cache.Release(info.fd);
       return;  // file mode error || autoindex
     }
-    in_fd_ = OpenResource(router_result_.success_path.c_str(), O_RDONLY);
-    if (in_fd_ == -1) {
+    file_path_ = router_result_.success_path;
+    result_.ext = ParseExtension(router_result_.success_path);
+    SelectPrecompressed(info);
+    SetValidators(info);
+    const bool kIsGzip = (info.size <= GZIP_FILE_MAX &&
+                          IsCompressible(static_cast<size_t>(info.size)));
+    if (IsNotModified(info) == true) {
+      result_.status = 304;  // NOT MODIFIED
+      io_status_ = SetIoComplete(IO_COMPLETE);
+      return g_open_file_cache.Release(info.fd);
+    }
+    RangeVector ranges;
+    if (ParseRange(info.size, ranges) == true) {
+      return SetRangeBody(info, ranges);  // 압축하지 않은 파일의 범위
+    }
+    if ((kIsGzip == true || info.size <= STATIC_CACHE_FILE_MAX) &&
+        SetCachedBody(info, kIsGzip) == true) {
+      return g_open_file_cache.Release(info.fd);
+    }
+    SetFileBody(info);
+  }
+}
+
+/**
+ * @brief GET 으로 open 할 파일 (원본, 받을 수 있는 압축 사이드카) 중 open file
+ * cache 에 없는 파일들을 작업 스레드에서 open, 완료되면 캐시에 저장하고 Get 을
+ * 처음부터 다시 실행해 캐시에서 바로 받음
+ * 캐시된 응답으로 보낼 크기의 파일은 작업 스레드에서 내용까지 읽어 둠
+ *
+ * @return true 작업 스레드에서 open 중
+ * @return false 모두 캐시에 있거나 이벤트 루프에서 open 을 마침
+ */
+bool FileManager::PrefetchFiles(void) {
+  if (is_prefetched_ == true) {
+    return false;
+  }
+  is_prefetched_ = true;
+  const std::string& kPath = router_result_.success_path;
+  std::vector<std::string> paths(1, kPath);
+  if (router_result_.brotli_static == true && AcceptsEncoding("br") == true) {
+    paths.push_back(kPath + ".br");
+  }
+  if (router_result_.gzip_static == true && AcceptsEncoding("gzip") == true) {
+    paths.push_back(kPath + ".gz");
+  }
+  const GzipOption* kGzip = router_result_.gzip;
+  result_.ext = ParseExtension(kPath);  // gzip 대상 MIME 타입 판별
+  const off_t kReadMax =
+      (kGzip != NULL && kGzip->is_on == true &&
+       kGzip->types.count(DetermineMimeType()) == 1 &&
+       AcceptsEncoding("gzip") == true)
+          ? GZIP_FILE_MAX
+          : STATIC_CACHE_FILE_MAX;
+  DiskTask* task = NULL;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    if (g_open_file_cache.IsFresh(paths[i]) == true) {
+      continue;
+    }
+    if (task == NULL) {
+      task = new (std::nothrow) DiskTask(LoadFiles);
+      if (task == NULL) {
+        return false;  // Get 에서 직접 open
+      }
+    }
+    task->paths.push_back(paths[i]);
+    task->root_fd = router_result_.root_fd;
+    task->root_len = router_result_.root_len;
+    task->read_max = kReadMax;
+  }
+  return (task != NULL && RunDiskTask(task) == true);
+}
+
+/**
+ * @brief gzip_static / brotli_static 이 켜져 있으면 클라이언트가 받는 encoding
+ * 으로 미리 압축된 사이드카 (.br, .gz) 중 원본보다 최신인 파일을 원본 대신
+ * 선택, MIME 타입은 원본 확장자로 결정
+ *
+ * @param info 원본 파일 정보, 사이드카를 선택하면 사이드카 정보로 교체
+ */
+void FileManager::SelectPrecompressed(OpenFileCache::Info& info) {
+  const bool kIsEnabled[2] = {router_result_.brotli_static,
+                              router_result_.gzip_static};
+  const char* kEncodings[2] = {"br", "gzip"};  // 우선 순위 순
+  const char* kSuffixes[2] = {".br", ".gz"};
+  if (kIsEnabled[0] == false && kIsEnabled[1] == false) {
+    return;
+  }
+  AddVaryAcceptEncoding();
+  for (size_t i = 0; i < 2; ++i) {
+    if (kIsEnabled[i] == false || AcceptsEncoding(kEncodings[i]) == false) {
+      continue;
+    }
+    OpenFileCache::Info sidecar =
+        g_open_file_cache.Open(router_result_.success_path + kSuffixes[i],
+                               router_result_.root_fd, router_result_.root_len);
+    if (sidecar.fd != -1 && sidecar.mtime >= info.mtime) {
+      g_open_file_cache.Release(info.fd);
+      info = sidecar;
+      file_path_ = router_result_.success_path + kSuffixes[i];
+      result_.header["content-encoding"] = kEncodings[i];
       return;
     }
-    io_status_ = FILE_READ;
+    g_open_file_cache.Release(sidecar.fd);
+  }
+}
+
+/**
+ * @brief 파일 stat 정보로 ETag, Last-Modified 헤더 설정 및 Range 지원 광고
+ *
+ * @param kInfo open file cache 에서 받은 파일 정보
+ */
+void FileManager::SetValidators(const OpenFileCache::Info& kInfo) {
+  result_.header["accept-ranges"] = "bytes";
+  result_.header["etag"] =
+      header_formatter_.FormatETag(kInfo.inode, kInfo.size, kInfo.mtime);
+  result_.header["last-modified"] =
+      header_formatter_.FormatHttpDate(kInfo.mtime);
+}
+
+/**
+ * @brief 조건부 요청 평가, If-None-Match 가 있으면 ETag 를 weak 비교하고
+ * 없으면 If-Modified-Since 이후로 파일이 수정되지 않았는지 확인
+ *
+ * @param kInfo open file cache 에서 받은 파일 정보
+ * @return true 304 Not Modified 로 응답
+ * @return false 파일 전송
+ */
+bool FileManager::IsNotModified(const OpenFileCache::Info& kInfo) {
+  Fields::iterator it = request_.header.find(Fields::kIfNoneMatch);
+  if (it != request_.header.end()) {
+    return DoesETagMatch(it->second, result_.header["etag"]);
+  }
+  it = request_.header.find(Fields::kIfModifiedSince);
+  if (it == request_.header.end() || it->second.size() != 1) {
+    return false;
+  }
+  struct tm since;
+  memset(&since, 0, sizeof(since));
+  const char* kEnd = strptime(it->second.front().c_str(), HTTP_DATE_FORMAT,
+                              &since);
+  if (kEnd == NULL || *kEnd != '\0') {
+    return false;  // 유효하지 않은 날짜는 무시
+  }
+  return (kInfo.mtime <= timegm(&since));
+}
+
+/**
+ * @brief If-None-Match 의 entity-tag 리스트 중 ETag 와 weak 비교로 일치하는
+ * 것이 있는지 확인
+ *
+ * @param kValues If-None-Match 필드 값 리스트
+ * @param kETag 현재 파일의 ETag
+ * @return true
+ * @return false
+ */
+bool FileManager::DoesETagMatch(const Fields::Values& kValues,
+                                const std::string& kETag) {
+  const std::string kOpaqueTag = kETag.substr(kETag.find('"'));
+  for (size_t i = 0; i < kValues.size(); ++i) {
+    std::istringstream ss(kValues[i]);
+    std::string tag;
+    while (std::getline(ss, tag, ',')) {
+      size_t start = tag.find_first_not_of(SP HTAB);
+      if (start == std::string::npos) {
+        continue;
+      }
+      size_t end = tag.find_last_not_of(SP HTAB);
+      tag = tag.substr(start, end - start + 1);
+      if (tag == "*") {
+        return true;
+      }
+      if (tag.compare(0, 2, "W/") == 0) {
+        tag.erase(0, 2);
+      }
+      if (tag == kOpaqueTag) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Range 헤더를 byte 범위 리스트로 파싱, If-Range 가 현재 파일과 다르거나
+ * 문법이 틀렸거나 범위가 RANGE_COUNT_MAX 개를 넘으면 Range 를 무시
+ * 파일 크기를 벗어나는 범위는 제외하고 끝 위치는 파일 크기에 맞춤
+ *
+ * @param size 파일 크기
+ * @param ranges 파싱한 [first, last] 범위 리스트, 만족하는 범위가 없으면 빈
+ * 리스트
+ * @return true Range 적용
+ * @return false Range 무시, 파일 전체 전송
+ */
+bool FileManager::ParseRange(off_t size, RangeVector& ranges) {
+  Fields::iterator it = request_.header.find(Fields::kRange);
+  if (it == request_.header.end() || it->second.size() != 1 ||
+      DoesIfRangeMatch() == false ||
+      strncasecmp(it->second.front().c_str(), "bytes=", 6) != 0) {
+    return false;
   }
-  if (io_status_ == FILE_READ) {
-    ReadFile(in_fd_);
+  std::istringstream ss(it->second.front().substr(6));
+  std::string spec;
+  size_t count = 0;
+  while (std::getline(ss, spec, ',')) {
+    size_t start = spec.find_first_not_of(SP HTAB);
+    if (start == std::string::npos) {
+      continue;
+    }
+    spec = spec.substr(start, spec.find_last_not_of(SP HTAB) - start + 1);
+    size_t dash = spec.find('-');
+    if (++count > RANGE_COUNT_MAX || dash == std::string::npos ||
+        spec.size() == 1) {
+      return false;
+    }
+    off_t first = ParseBytePos(spec.substr(0, dash));
+    off_t last = ParseBytePos(spec.substr(dash + 1));
+    if (dash == 0) {  // suffix-range: 마지막 last 바이트
+      if (last < 0) {
+        return false;
+      }
+      first = std::max(static_cast<off_t>(0), size - last);
+      last = (last > 0) ? size - 1 : -1;
+    } else if (first < 0 || (dash + 1 < spec.size() && last < first)) {
+      return false;
+    } else {
+      last = (dash + 1 == spec.size() || last >= size) ? size - 1 : last;
+    }
+    if (first < size && first <= last) {
+      ranges.push_back(std::make_pair(first, last));
+    }
   }
+  return (count > 0);
+}
+
+/**
+ * @brief byte 위치 문자열을 숫자로 변환
+ *
+ * @param kPos 10진수 문자열
+ * @return off_t 변환된 위치, 숫자가 아니거나 너무 크면 -1
+ */
+off_t FileManager::ParseBytePos(const std::string& kPos) {
+  if (kPos.empty() == true || kPos.size() > 18 ||
+      kPos.find_first_not_of(DIGIT) != std::string::npos) {
+    return -1;
+  }
+  off_t pos = 0;
+  for (size_t i = 0; i < kPos.size(); ++i) {
+    pos = pos * 10 + (kPos[i] - '0');
+  }
+  return pos;
+}
+
+/**
+ * @brief If-Range 가 있으면 현재 파일과 같은지 확인, entity-tag 는 strong
+ * 비교만 허용되므로 weak ETag 를 쓰는 서버에서는 날짜만 일치할 수 있음
+ *
+ * @return true If-Range 가 없거나 Last-Modified 와 일치
+ * @return false
+ */
+bool FileManager::DoesIfRangeMatch(void) {
+  Fields::iterator it = request_.header.find(Fields::kIfRange);
+  if (it == request_.header.end()) {
+    return true;
+  }
+  return (it->second.size() == 1 &&
+          it->second.front() == result_.header["last-modified"]);
+}
+
+/**
+ * @brief Range 응답 생성, 범위가 하나면 해당 범위만 sendfile 로 전송하고
+ * 여러 개면 범위들만 읽어서 multipart/byteranges 로 전송
+ * 만족하는 범위가 없으면 416, 읽을 범위가 RANGE_BUFF_MAX 를 넘으면 Range 를
+ * 무시하고 파일 전체 전송
+ *
+ * @param kInfo open file cache 에서 받은 파일 정보
+ * @param kRanges 파싱한 범위 리스트
+ */
+void FileManager::SetRangeBody(const OpenFileCache::Info& kInfo,
+                               const RangeVector& kRanges) {
+  std::stringstream ss;
+  if (kRanges.empty() == true) {
+    ss << "bytes */" << kInfo.size;
+    result_.header["content-range"] = ss.str();
+    result_.status = 416;  // RANGE NOT SATISFIABLE
+    return g_open_file_cache.Release(kInfo.fd);
+  }
+  if (kRanges.size() == 1) {
+    ss << "bytes " << kRanges[0].first << "-" << kRanges[0].second << "/"
+       << kInfo.size;
+    result_.header["content-range"] = ss.str();
+    result_.status = 206;  // PARTIAL CONTENT
+    SetFileBody(kInfo);
+    response_buffer_.file_offset = kRanges[0].first;
+    response_buffer_.file_size = kRanges[0].second - kRanges[0].first + 1;
+    file_size_ = response_buffer_.file_size;
+    return;
+  }
+  off_t total_len = 0;
+  for (size_t i = 0; i < kRanges.size(); ++i) {
+    total_len += kRanges[i].second - kRanges[i].first + 1;
+  }
+  if (total_len > RANGE_BUFF_MAX) {
+    return SetFileBody(kInfo);  // Range 무시
+  }
+  SetMultipartRangeBody(kInfo, kRanges, total_len);
+  g_open_file_cache.Release(kInfo.fd);
+}
+
+/**
+ * @brief 여러 범위를 읽어 multipart/byteranges content 생성
+ *
+ * @param kInfo open file cache 에서 받은 파일 정보
+ * @param kRanges 파싱한 범위 리스트
+ * @param total_len 범위들의 총 바이트 수
+ */
+void FileManager::SetMultipartRangeBody(const OpenFileCache::Info& kInfo,
+                                        const RangeVector& kRanges,
+                                        off_t total_len) {
+  static unsigned long boundary_seq = 0;
+  std::stringstream boundary;
+  boundary << "BrilliantServerRange" << std::hex << ++boundary_seq;
+  ResponseHeaderMap no_header;
+  std::string mime = header_formatter_.FormatContentType(
+      false, ParseExtension(router_result_.success_path), no_header);
+  response_content_.reserve(total_len + kRanges.size() * 128);
+  for (size_t i = 0; i < kRanges.size(); ++i) {
+    std::stringstream part;
+    part << CRLF "--" << boundary.str() << CRLF;
+    if (mime.empty() == false) {
+      part << "content-type: " << mime << CRLF;
+    }
+    part << "content-range: bytes " << kRanges[i].first << "-"
+         << kRanges[i].second << "/" << kInfo.size << CRLF CRLF;
+    response_content_ += part.str();
+    size_t part_start = response_content_.size();
+    size_t part_len = kRanges[i].second - kRanges[i].first + 1;
+    response_content_.resize(part_start + part_len);
+    if (OpenFileCache::ReadFull(kInfo.fd, &response_content_[part_start],
+                                part_len, kRanges[i].first) !=
+        static_cast<ssize_t>(part_len)) {
+      response_content_.clear();
+      result_.status = 500;  // INTERNAL SERVER ERROR
+      return;
+    }
+  }
+  response_content_ += CRLF "--" + boundary.str() + "--" CRLF;
+  result_.header["content-type"] =
+      "multipart/byteranges; boundary=" + boundary.str();
+  result_.status = 206;  // PARTIAL CONTENT
+  io_status_ = SetIoComplete(IO_COMPLETE);
+}
+
+/**
+ * @brief 연 파일을 읽지 않고 응답 버퍼에 넘겨 Connection 이 sendfile 로
+ * 전송하도록 설정 (sendfile off 면 제한된 버퍼로 나눠 읽으며 전송),
+ * content-length 는 캐시된 stat 의 파일 크기
+ *
+ * @param kInfo open file cache 에서 받은 파일 정보
+ */
+void FileManager::SetFileBody(const OpenFileCache::Info& kInfo) {
+  file_size_ = kInfo.size;
+  response_buffer_.is_streamed = (router_result_.sendfile == false);
+  response_buffer_.file_fd = kInfo.fd;
+  response_buffer_.file_offset = 0;
+  response_buffer_.file_size = kInfo.size;
+  io_status_ = SetIoComplete(IO_COMPLETE);
+}
+
+/**
+ * @brief 작은 파일은 헤더 뒷부분과 content 를 미리 만들어 둔 캐시된 응답을
+ * 응답 버퍼에 넘김, 캐시에 없거나 파일이 바뀌었으면 읽어서 캐시에 추가
+ * gzip 압축한 응답은 "<경로>\0gzip" 키로 원본과 따로 캐시
+ * 같은 파일을 gzip 설정이 다른 location 이 보내면 vary 와 압축 수준이 달라
+ * 캐시된 응답을 다시 만듦
+ * 파일 내용은 작업 스레드가 읽어 둔 것을 사용하고, 없으면 작업 스레드에 읽기를
+ * 넘긴 후 Get 을 다시 실행
+ *
+ * @param kInfo open file cache 에서 받은 파일 정보
+ * @param is_gzip gzip 압축한 응답 사용 여부
+ * @return true 캐시된 응답 사용 || 작업 스레드에서 파일 읽는 중
+ * @return false 캐시 불가, 파일을 그대로 전송
+ */
+bool FileManager::SetCachedBody(const OpenFileCache::Info& kInfo,
+                                bool is_gzip) {
+  const std::string kKey =
+      (is_gzip == true) ? file_path_ + '\0' + "gzip" : file_path_;
+  ResponseHeaderMap::const_iterator vary_it = result_.header.find("vary");
+  const std::string kVary =
+      (vary_it != result_.header.end()) ? vary_it->second : "";
+  const int kGzipLevel = (is_gzip == true) ? router_result_.gzip->level : 0;
+  CachedResponse* cached = g_static_response_cache.Find(
+      kKey, router_result_.methods, router_result_.cache->header, kVary,
+      kGzipLevel, kInfo.size, kInfo.mtime, kInfo.inode);
+  if (cached == NULL) {
+    std::string* content = FindLoadedContent(kInfo);
+    if (content == NULL && is_content_read_ == false) {
+      is_content_read_ = true;
+      if (ReadFileContent(kInfo) == true) {
+        return true;  // 작업 스레드에서 읽는 중
+      }
+      content = FindLoadedContent(kInfo);
+    }
+    cached = (content != NULL)
+                 ? LoadCachedResponse(kInfo, kKey, is_gzip, *content)
+                 : NULL;
+    if (cached == NULL) {
+      return false;
+    }
+  }
+  if (is_gzip == true) {
+    result_.header["content-encoding"] = "gzip";  // blob 에 들어 있는 값
+  }
+  file_size_ = kInfo.size;
+  response_buffer_.cached = cached;
+  io_status_ = SetIoComplete(IO_COMPLETE);
+  return true;
+}
+
+/**
+ * @brief 작업 스레드가 읽어 둔 파일 내용 중 kInfo 와 같은 파일의 내용 찾기
+ *
+ * @param kInfo open file cache 에서 받은 파일 정보
+ * @return std::string* 파일 내용, 없거나 읽은 후 파일이 바뀌었으면 NULL
+ */
+std::string* FileManager::FindLoadedContent(const OpenFileCache::Info& kInfo) {
+  LoadedFileMap::iterator it = loaded_files_.find(file_path_);
+  if (it == loaded_files_.end() || it->second.info.size != kInfo.size ||
+      it->second.info.mtime != kInfo.mtime ||
+      it->second.info.inode != kInfo.inode) {
+    return NULL;
+  }
+  return &it->second.content;
+}
+
+/**
+ * @brief open file cache 에는 있지만 캐시된 응답이 없는 파일을 작업 스레드에서
+ * 다시 open 해 끝까지 읽음, 완료되면 Get 을 다시 실행
+ *
+ * @param kInfo open file cache 에서 받은 파일 정보
+ * @return true 작업 스레드에서 읽는 중
+ * @return false 이벤트 루프에서 읽기를 마침 || 작업 할당 실패
+ */
+bool FileManager::ReadFileContent(const OpenFileCache::Info& kInfo) {
+  DiskTask* task = new (std::nothrow) DiskTask(LoadFiles);
+  if (task == NULL) {
+    return false;  // 파일을 그대로 전송
+  }
+  task->paths.push_back(file_path_);
+  task->root_fd = router_result_.root_fd;
+  task->root_len = router_result_.root_len;
+  task->read_max = kInfo.size;
+  return RunDiskTask(task);
+}
+
+/**
+ * @brief 작업 스레드가 읽은 파일 내용을 (gzip 이면 압축해) 헤더 뒷부분 뒤에
+ * 이어 붙인 응답 생성 후 캐시에 추가
+ *
+ * @param kInfo open file cache 에서 받은 파일 정보
+ * @param kKey 캐시 키
+ * @param is_gzip gzip 압축 여부
+ * @param kContent 파일 내용
+ * @return CachedResponse* 생성된 응답, 실패 시 NULL
+ */
+CachedResponse* FileManager::LoadCachedResponse(
+    const OpenFileCache::Info& kInfo, const std::string& kKey, bool is_gzip,
+    const std::string& kContent) {
+  std::string compressed;
+  if (is_gzip == true &&
+      Gzip().Compress(kContent.data(), kContent.size(),
+                      router_result_.gzip->level, compressed) == false) {
+    return NULL;
+  }
+  const std::string& kBody = (is_gzip == true) ? compressed : kContent;
+  CachedResponse* response = new (std::nothrow) CachedResponse();
+  if (response == NULL) {
+    return NULL;  // 원본 파일을 그대로 보내므로 content-encoding 없음
+  }
+  if (is_gzip == true) {
+    result_.header["content-encoding"] = "gzip";
+  }
+  response->blob.reserve(HEADER_RESERVE + kBody.size());
+  AppendInvariantHeader(response->blob, kBody.size());
+  response->blob += kBody;
+  response->methods = router_result_.methods;
+  response->cache_header = router_result_.cache->header;
+  ResponseHeaderMap::const_iterator vary_it = result_.header.find("vary");
+  if (vary_it != result_.header.end()) {
+    response->vary = vary_it->second;
+  }
+  response->gzip_level = (is_gzip == true) ? router_result_.gzip->level : 0;
+  response->size = kInfo.size;
+  response->mtime = kInfo.mtime;
+  response->inode = kInfo.inode;
+  return g_static_response_cache.Insert(kKey, response);
 }
 
 /**
  * @brief POST 요청이 왔을 때 요청 내용으로 파일을 생성하고 성공 시 응답 생성,
- * 실패 시 에러코드 설정
+ * 실패 시 에러코드 설정, 파일 생성과 쓰기는 작업 스레드에서 실행
  *
  */
 void FileManager::Post(void) {
   if (io_status_ == IO_START) {
-    if (FindValidOutputPath(router_result_.success_path) == false) {
-      return;  // 403 or 500
-    }
-    out_fd_ = OpenResource(output_path_.c_str(), O_WRONLY | O_CREAT);
-    if (out_fd_ == -1) {
+    DiskTask* task = new (std::nothrow) DiskTask(CreateOutputFile);
+    if (task == NULL) {
+      result_.status = 500;  // INTERNAL SERVER ERROR
       return;
     }
-    io_status_ = FILE_WRITE;
-  }
-  if (io_status_ == FILE_WRITE && WriteFile(request_.content) < 0) {
-    unlink(output_path_.c_str());
+    task->path = router_result_.success_path;
+    task->root_fd = router_result_.root_fd;
+    task->root_len = router_result_.root_len;
+    task->content.swap(request_.content);
+    if (RunDiskTask(task) == true) {
+      return;  // 작업 스레드에서 파일 작성 중
+    }
   }
   if (io_status_ == IO_COMPLETE) {
+    g_open_file_cache.Invalidate(output_path_);
+    g_static_response_cache.Invalidate(output_path_);
     result_.status = 201;  // CREATED
     result_.location.assign(output_path_, 1);
     response_content_ =
         "<!DOCTYPE html><html><title>201 Created</title><body><h1>201 "
         "Created</h1><p>YAY! The file is created at " +
         result_.location + "!</p><p>Have a nice day~</p></body></html>";
-    close(out_fd_);
-    out_fd_ = -1;
   }
 }
 
 /**
- * @brief POST 요청 시 파일에 내용 작성 및 I/O 상태 설정
+ * @brief DELETE 요청이 왔을 때 파일 삭제 및 응답 생성, 실패 시 에러코드 설정,
+ * 파일 삭제는 작업 스레드에서 실행
  *
- * @param kReqContent 요청 content
- * @return ssize_t 작성한 바이트 수. 에러시 -1 반환
  */
-ssize_t FileManager::WriteFile(const std::string& kReqContent) {
-  size_t size = (kReqContent.size() < WRITE_BUFF_SIZE + write_offset_)
-                    ? kReqContent.size() - write_offset_
-                    : WRITE_BUFF_SIZE;
-  ssize_t written_bytes = write(out_fd_, &kReqContent[write_offset_], size);
-  if (written_bytes < 0) {
-    result_.status = 500;  // INTERNAL SERVER ERROR
-    return -1;
+void FileManager::Delete(void) {
+  if (io_status_ == IO_START) {
+    DiskTask* task = new (std::nothrow) DiskTask(RemoveFile);
+    if (task == NULL) {
+      result_.status = 500;  // INTERNAL SERVER ERROR
+      return;
+    }
+    task->path = router_result_.success_path;
+    task->root_fd = router_result_.root_fd;
+    task->root_len = router_result_.root_len;
+    if (RunDiskTask(task) == true) {
+      return;  // 작업 스레드에서 파일 삭제 중
+    }
+  }
+  if (io_status_ == IO_COMPLETE) {
+    g_open_file_cache.Invalidate(router_result_.success_path);
+    g_static_response_cache.Invalidate(router_result_.success_path);
+    result_.status = 200;  // OK
+    response_content_ =
+        "<!DOCTYPE html><html><title>Deleted</title><body><h1>200 OK</h1><p>" +
+        router_result_.success_path.substr(1) +
+        " is removed!</p></body></html>";
   }
-  write_offset_ += written_bytes;
-  io_status_ = (write_offset_ >= kReqContent.size()) ? IO_COMPLETE : FILE_WRITE;
-  return written_bytes;
 }
 
 /**
- * @brief POST 요청 시 생성할 파일의 이름 설정
+ * @brief 작업을 작업 스레드에 넘기고 완료 알림 fd 를 기다리도록 설정, 스레드나
+ * pipe 를 쓸 수 없으면 이벤트 루프에서 바로 실행하고 결과 반영
  *
- * @param success_path 요청에서 제공해 준 경로
- * @return true
- * @return false
+ * @param task new 로 할당한 작업
+ * @return true 작업 스레드에서 실행 중
+ * @return false 직접 실행해 결과까지 반영함
  */
-bool FileManager::FindValidOutputPath(std::string& success_path) {
-  size_t ext_start = success_path.rfind('.');
-  std::string name(success_path);
-  std::string ext("");
-  if (ext_start > 0 && ext_start < name.size() - 1) {
-    name.assign(success_path, 0, ext_start);
-    ext.assign(success_path, ext_start);
-  }
-  output_path_ = success_path;
-  int i = 0;
-  for (; i < FILE_IDX_MAX; ++i) {
-    if (access(output_path_.c_str(), F_OK) == -1) {
-      if (errno != ENOENT) {
-        result_.status = 500;  // INTERNAL_SERVER_ERROR
-        return false;
-      }
-      break;
-    }
-    std::stringstream ss;
-    ss << name << "_" << i << ext;
-    output_path_ = ss.str();
+bool FileManager::RunDiskTask(DiskTask* task) {
+  int done_fd = g_disk_io_pool.Submit(task);
+  if (done_fd == -1) {
+    task->routine(*task);
+    ApplyDiskTask(*task);
+    g_disk_io_pool.Release(task);
+    return false;
   }
-  if (i == FILE_IDX_MAX) {
-    result_.status = 403;  // FORBIDDEN
-    output_path_.clear();
+  disk_task_ = task;
+  in_fd_ = done_fd;
+  io_status_ = FILE_READ;
+  return true;
+}
+
+/**
+ * @brief 완료 알림 이벤트가 오면 작업 결과를 반영하고 작업 참조 반납
+ *
+ * @return true 작업 결과 반영 완료
+ * @return false 아직 작업 중
+ */
+bool FileManager::CollectDiskTask(void) {
+  if (g_disk_io_pool.IsDone(disk_task_) == false) {
     return false;
   }
+  close(in_fd_);
+  in_fd_ = -1;
+  io_status_ = IO_START;
+  ApplyDiskTask(*disk_task_);
+  g_disk_io_pool.Release(disk_task_);
+  disk_task_ = NULL;
   return true;
 }
 
 /**
- * @brief DELETE 요청이 왔을 때 파일 삭제 및 응답 생성, 실패 시 에러코드 설정
+ * @brief 작업 결과를 이벤트 루프에서 반영, GET 은 open 한 파일들을 open file
+ * cache 에 저장하고 읽어 둔 파일 내용과 디렉토리 엔트리를 넘겨받은 후 Get 을
+ * 다시 실행, POST / DELETE 는 결과 상태 설정
+ * 실패하면 ERROR_START 로 바꿔 Post / Delete 가 작업을 다시 넘기지 않게 함
  *
+ * @param task 끝난 작업, 읽은 내용은 매니저로 옮겨짐
  */
-void FileManager::Delete(void) {
-  errno = 0;
-  if (access(router_result_.success_path.c_str(), W_OK) == -1) {
-    if (errno == ENOENT) {
-      result_.status = 404;  // PAGE NOT FOUND
-    } else if (errno == EACCES) {
-      result_.status = 403;  // FORBIDDEN
-    } else {
-      result_.status = 500;  // INTERNAL_SERVER_ERROR
+void FileManager::ApplyDiskTask(DiskTask& task) {
+  if (task.routine == ReadDirectory) {
+    dir_status_ = task.status;
+    dir_mtime_ = task.mtime;
+    dir_inode_ = task.inode;
+    dir_names_.swap(task.names);
+    return;
+  }
+  if (request_.req.method == GET) {
+    for (size_t i = 0; i < task.paths.size(); ++i) {
+      const OpenFileCache::Info& kInfo = task.infos[i];
+      g_open_file_cache.Store(task.paths[i], kInfo);
+      if (kInfo.fd != -1 && kInfo.size <= task.read_max &&
+          task.contents[i].size() == static_cast<size_t>(kInfo.size)) {
+        LoadedFile& loaded = loaded_files_[task.paths[i]];
+        loaded.info = kInfo;
+        loaded.content.swap(task.contents[i]);
+      }
     }
     return;
   }
-  if (unlink(router_result_.success_path.c_str()) == -1) {
-    result_.status = 500;  // INTERNAL_SERVER_ERROR
+  if (task.status != 0) {
+    result_.status = task.status;
+    io_status_ = SetIoComplete(ERROR_START);
     return;
   }
-  result_.status = 200;  // OK
-  response_content_ =
-      "<!DOCTYPE html><html><title>Deleted</title><body><h1>200 OK</h1><p>" +
-      router_result_.success_path.substr(1) + " is removed!</p></body></html>";
+  if (request_.req.method == POST) {
+    output_path_ = task.path;
+  }
   io_status_ = IO_COMPLETE;
 }
 
 /**
- * @brief GET 혹은 POST 요청 시 파일 open. 실패 시 에러 코드 설정
+ * @brief (작업 스레드) 파일들을 open 하고, read_max 이하인 파일은 캐시된
+ * 응답을 만들 수 있게 내용까지 읽어 둠
  *
- * @param kPath open 할 파일 경로
- * @param kFlags open flag (O_RDONLY, O_WRONLY | O_CREAT)
- * @return int open된 파일 디스크립터. 실패 시 -1 반환
+ * @param task paths 를 open 해 infos, contents 에 저장할 작업
  */
-int FileManager::OpenResource(const char* kPath, const int kFlags) {
+void FileManager::LoadFiles(DiskTask& task) {
+  for (size_t i = 0; i < task.paths.size(); ++i) {
+    task.infos.push_back(
+        OpenFileCache::Load(task.paths[i], task.root_fd, task.root_len));
+    task.contents.push_back(std::string());
+    const OpenFileCache::Info& kInfo = task.infos.back();
+    if (kInfo.fd != -1 && kInfo.size > 0 && kInfo.size <= task.read_max) {
+      std::string& content = task.contents.back();
+      content.resize(kInfo.size);
+      if (OpenFileCache::ReadFull(kInfo.fd, &content[0], content.size(), 0) !=
+          kInfo.size) {
+        content.clear();  // 읽는 도중 파일이 바뀜 || read 에러
+      }
+    }
+  }
+}
+
+/**
+ * @brief (작업 스레드) autoindex 를 만들 디렉토리를 열어 숨김 파일을 제외한
+ * 엔트리 이름을 읽음, 캐시된 페이지의 mtime/inode 와 같으면 읽지 않고 304
+ *
+ * @param task path 디렉토리를 읽어 names 에 저장할 작업
+ */
+void FileManager::ReadDirectory(DiskTask& task) {
+  struct stat dir_stat;
+  int dir_fd = OpenFileCache::OpenDir(task.path, task.root_fd, task.root_len);
+  if (dir_fd == -1 || fstat(dir_fd, &dir_stat) == -1) {
+    if (dir_fd != -1) {
+      close(dir_fd);
+    }
+    task.status = 500;  // INTERNAL_SERVER_ERROR
+    return;
+  }
+  if (dir_stat.st_mtime == task.mtime && dir_stat.st_ino == task.inode) {
+    close(dir_fd);
+    task.status = 304;  // 캐시된 페이지 그대로 사용
+    return;
+  }
+  task.mtime = dir_stat.st_mtime;
+  task.inode = dir_stat.st_ino;
+  if (ReadAutoindexEntries(dir_fd, task.names) == false) {
+    task.status = 500;  // INTERNAL_SERVER_ERROR
+  }
+}
+
+/**
+ * @brief (작업 스레드) 디렉토리의 숨김 파일을 제외한 엔트리 이름 읽기
+ *
+ * @param dir_fd OpenDir 로 연 디렉토리, 성공 여부와 관계없이 close
+ * @param names 엔트리 이름을 추가할 벡터 (디렉토리는 '/' 로 끝남)
+ * @return true
+ * @return false fdopendir/readdir/stat 실패
+ */
+bool FileManager::ReadAutoindexEntries(int dir_fd,
+                                       std::vector<std::string>& names) {
+  DIR* dir = fdopendir(dir_fd);
+  if (dir == NULL) {
+    close(dir_fd);
+    return false;
+  }
   errno = 0;
-  int fd =
-      (kFlags == O_RDONLY) ? open(kPath, kFlags) : open(kPath, kFlags, 0644);
+  for (dirent* ent = readdir(dir); ent != NULL; ent = readdir(dir)) {
+    if (ent->d_name[0] == '.') {
+      continue;
+    }
+    names.push_back(std::string());
+    if (AutoindexStream::ReadEntry(dirfd(dir), ent, names.back()) == false) {
+      break;
+    }
+  }
+  closedir(dir);
+  return (errno == 0);
+}
+
+/**
+ * @brief (작업 스레드) POST 로 생성할 파일을 이름이 겹치지 않게 만들고 내용을
+ * 모두 작성, 이미 있으면 이름 뒤에 번호를 붙여 다시 시도
+ * 쓰기에 실패하면 만든 파일 삭제
+ *
+ * @param task path 에 content 를 쓸 작업, 성공 시 path 는 생성한 파일 경로
+ */
+void FileManager::CreateOutputFile(DiskTask& task) {
+  size_t ext_start = task.path.rfind('.');
+  std::string name(task.path);
+  std::string ext("");
+  if (ext_start > 0 && ext_start < name.size() - 1) {
+    name.assign(task.path, 0, ext_start);
+    ext.assign(task.path, ext_start);
+  }
+  std::string output_path(task.path);
+  int flags = O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC;
+  if (task.root_fd != AT_FDCWD) {
+    flags |= ROOT_RESOLVE_FLAGS;
+  }
+  int fd = -1;
+  for (int i = 0; i < FILE_IDX_MAX; ++i) {
+    fd = openat(task.root_fd,
+                OpenFileCache::GetRelativePath(output_path, task.root_len),
+                flags, 0644);
+    if (fd != -1 || errno != EEXIST) {
+      break;
+    }
+    std::stringstream ss;
+    ss << name << "_" << i << ext;
+    output_path = ss.str();
+  }
   if (fd == -1) {
-    if (errno == ENOENT) {
-      result_.status = 404;  // PAGE NOT FOUND
-    } else if (errno == EACCES) {
-      result_.status = 403;  // FORBIDDEN
-    } else if (errno == EMFILE) {
-      result_.status = 503;  // SERVICE UNAVAILABLE
-    } else {
-      result_.status = 500;  // INTERNAL SERVER ERROR}
+    task.status = (errno == EEXIST) ? 403 : ConvertErrnoToStatus(errno);
+    return;
+  }
+  size_t written = 0;
+  while (written < task.content.size()) {
+    ssize_t written_bytes = write(fd, task.content.data() + written,
+                                  task.content.size() - written);
+    if (written_bytes == -1 && errno == EINTR) {
+      continue;
     }
-  } else {
-    fcntl(fd, F_SETFL, O_NONBLOCK);
+    if (written_bytes <= 0) {
+      break;
+    }
+    written += written_bytes;
+  }
+  if (close(fd) == -1 || written < task.content.size()) {
+    unlinkat(task.root_fd,
+             OpenFileCache::GetRelativePath(output_path, task.root_len), 0);
+    task.status = 500;  // INTERNAL SERVER ERROR
+    return;
+  }
+  task.path = output_path;
+}
+
+/**
+ * @brief (작업 스레드) DELETE 할 파일 삭제
+ *
+ * @param task path 를 삭제할 작업
+ */
+void FileManager::RemoveFile(DiskTask& task) {
+  const char* kRelPath =
+      OpenFileCache::GetRelativePath(task.path, task.root_len);
+  if (faccessat(task.root_fd, kRelPath, W_OK, 0) == -1) {
+    task.status = ConvertErrnoToStatus(errno);
+    return;
+  }
+  if (unlinkat(task.root_fd, kRelPath, 0) == -1) {
+    task.status = 500;  // INTERNAL SERVER ERROR
+  }
+}
+
+/**
+ * @brief 파일 시스템 작업 실패 errno 를 응답 상태 코드로 변환
+ *
+ * @param err errno
+ * @return int 상태 코드
+ */
+int FileManager::ConvertErrnoToStatus(int err) {
+  if (err == ENOENT || err == ENOTDIR) {
+    return 404;  // PAGE NOT FOUND
+  }
+  if (err == EACCES) {
+    return 403;  // FORBIDDEN
+  }
+  if (err == EMFILE || err == ENFILE) {
+    return 503;  // SERVICE UNAVAILABLE
   }
-  return fd;
+  return 500;  // INTERNAL SERVER ERROR
 }
 
 /**
@@ -251,101 +938,207 @@ ResponseManager::IoFdPair FileManager::GenerateRedirectPage(void) {
 }
 
 /**
- * @brief GET 요청 경로가 디렉토리인지 판별
+ * @brief GET 요청 경로가 디렉토리인지 판별, open 실패 시 에러코드 설정
  *
+ * @param kInfo open file cache 에서 받은 파일 정보
  */
-void FileManager::CheckFileMode(void) {
-  struct stat file_stat;
-  errno = 0;
-  if (stat(router_result_.success_path.c_str(), &file_stat) == -1) {
-    result_.status =
-        errno == ENOENT ? 404 : 500;  // NOT FOUND || INTERNAL_SERVER_ERROR
-    return;
-  }
-  file_size_ = file_stat.st_size;
-  if (S_ISDIR(file_stat.st_mode)) {
+void FileManager::CheckFileMode(const OpenFileCache::Info& kInfo) {
+  if (kInfo.is_dir == true) {
     (*(router_result_.success_path.rbegin()) == '/')
         ? result_.status = GenerateAutoindex(router_result_.success_path)
         : result_.status = 404;  // PAGE NOT FOUND
+    return;
+  }
+  if (kInfo.err != 0) {
+    result_.status = ConvertErrnoToStatus(kInfo.err);
   }
 }
 
 /**
  * @brief GET 요청이 디렉토리로 시도되었을 경우 디렉토리 내 파일 리스트 생성
+ * 디렉토리는 작업 스레드에서 읽고, 읽기가 끝나면 Get 을 다시 실행해 작성
+ * autoindex_sort off 면 정렬하지 않고 읽은 순서대로 chunked 로 전송, page/limit
+ * query 가 있으면 정렬 순서로 해당 페이지만 작성
+ * 전체 페이지는 디렉토리 mtime/inode 가 그대로면 캐시된 페이지를 사용하고,
+ * 아니면 필요한 크기를 미리 잡은 버퍼에 페이지를 만들어 캐시
  *
  * @param kPath 디렉토리 경로
  * @return int 실패 시 500, 성공 시 기존 status code 리턴
  */
 int FileManager::GenerateAutoindex(const std::string& kPath) {
-  DIR* dir = opendir(kPath.c_str());
-  if (dir == NULL) {
+  size_t page;
+  size_t limit;
+  const bool kIsPaged = ParseAutoindexPage(page, limit);
+  const bool kIsStreamed = (router_result_.autoindex_sort == false &&
+                            request_.req.version == HttpParser::kHttp1_1);
+  if (dir_status_ == 304 &&
+      g_autoindex_cache.Find(kPath, dir_mtime_, dir_inode_,
+                             response_content_) == true) {
+    result_.is_autoindex = true;
+    return result_.status;
+  }
+  if (dir_status_ == -1 || dir_status_ == 304) {  // 읽는 사이 캐시에서 빠짐
+    return LoadDirectory(kPath, dir_status_ == -1 && kIsPaged == false &&
+                                    kIsStreamed == false);
+  }
+  if (dir_status_ != 0) {
+    return dir_status_;
+  }
+  if (kIsStreamed == true) {
+    return StreamAutoindex(kPath);
+  }
+  std::vector<std::string>& names = dir_names_;
+  std::vector<std::string>::iterator first = names.begin();
+  std::vector<std::string>::iterator last = names.end();
+  if (kIsPaged == true) {
+    first += std::min((page - 1) * limit, names.size());
+    last = first + std::min(limit, static_cast<size_t>(names.end() - first));
+    std::nth_element(names.begin(), first, names.end(),
+                     AutoindexStream::IsOrdered);
+    std::partial_sort(first, last, names.end(), AutoindexStream::IsOrdered);
+  } else {
+    std::sort(first, last, AutoindexStream::IsOrdered);
+  }
+  std::string head = AutoindexStream::FormatHead(kPath);
+  size_t listing_len = head.size() + sizeof(AUTOINDEX_TAIL) - 1;
+  for (std::vector<std::string>::iterator it = first; it != last; ++it) {
+    listing_len += it->size() * 2 + AUTOINDEX_TAG_LEN;
+  }
+  response_content_.clear();
+  response_content_.reserve(listing_len);
+  response_content_ += head;
+  for (std::vector<std::string>::iterator it = first; it != last; ++it) {
+    AutoindexStream::AppendEntry(response_content_, *it);
+  }
+  if (kIsPaged == true) {
+    AppendAutoindexNav(page, limit, last != names.end());
+  }
+  response_content_ += AUTOINDEX_TAIL;
+  if (kIsPaged == false && dir_mtime_ < dir_read_time_) {  // 같은 초 안의
+    g_autoindex_cache.Insert(kPath, dir_mtime_,  // 변경은 mtime 으로 모름
+                             dir_inode_, response_content_);
+  }
+  result_.is_autoindex = true;
+  return result_.status;
+}
+
+/**
+ * @brief 디렉토리 읽기를 작업 스레드에 넘김, 작업 스레드를 쓸 수 없어 바로
+ * 읽었으면 이어서 autoindex 작성
+ *
+ * @param kPath 디렉토리 경로
+ * @param is_cached 캐시된 페이지의 mtime/inode 를 넘겨 디렉토리가 그대로면
+ * 다시 읽지 않게 할지 여부
+ * @return int 실패 시 500, 성공 시 기존 status code 리턴
+ */
+int FileManager::LoadDirectory(const std::string& kPath, bool is_cached) {
+  DiskTask* task = new (std::nothrow) DiskTask(ReadDirectory);
+  if (task == NULL) {
     return 500;  // INTERNAL_SERVER_ERROR
   }
-  std::string index_of = "Index of " + kPath.substr(1);
-  response_content_ = "<!DOCTYPE html><html><title>" + index_of +
-                      "</title><body><h1>" + index_of + "</h1><hr><pre>\n";
-  errno = 0;
-  std::vector<std::string> dir_vector;
-  std::vector<std::string> file_vector;
-  for (dirent* ent = readdir(dir); ent != NULL; ent = readdir(dir)) {
-    if (ent->d_name[0] != '.' &&
-        DetermineFileType(kPath, ent, dir_vector, file_vector) == false) {
-      break;
-    }
+  task->path = kPath;
+  task->root_fd = router_result_.root_fd;
+  task->root_len = router_result_.root_len;
+  if (is_cached == true) {
+    g_autoindex_cache.Peek(kPath, task->mtime, task->inode);
   }
-  closedir(dir);
-  if (errno != 0) {
+  dir_read_time_ = time(NULL);
+  if (RunDiskTask(task) == true) {
+    return result_.status;  // 작업 스레드에서 읽는 중
+  }
+  return GenerateAutoindex(kPath);
+}
+
+/**
+ * @brief 정렬하지 않는 autoindex 를 첫 AUTOINDEX_BATCH 개 엔트리만 바로
+ * 응답하고, 나머지는 Connection 이 송신할 때마다 chunk 로 이어서 작성하도록
+ * 설정
+ *
+ * @param kPath 디렉토리 경로
+ * @return int 실패 시 500, 성공 시 기존 status code 리턴
+ */
+int FileManager::StreamAutoindex(const std::string& kPath) {
+  AutoindexStream* stream =
+      new (std::nothrow) AutoindexStream(dir_names_, kPath);
+  if (stream == NULL) {
     return 500;  // INTERNAL_SERVER_ERROR
   }
-  ListAutoindexFiles(dir_vector);
-  ListAutoindexFiles(file_vector);
-  response_content_ += "</pre><hr></body></html>";
+  stream->Fill(response_content_);
+  response_buffer_.autoindex_stream = stream;
   result_.is_autoindex = true;
   return result_.status;
 }
 
 /**
- * @brief autoindex 페이지에 나열할 파일 타입 판별
+ * @brief autoindex 요청의 page, limit query 파싱, 잘못된 값은 무시
  *
- * @param kPath autoindex root 디렉토리 경로
- * @param kEnt 디렉토리 엔트리
- * @param dir_vector 디렉토리 경로 벡터
- * @param file_vector 파일 경로 벡터
- * @return true
- * @return false
+ * @param page 1 부터 시작하는 페이지 번호 (기본 1)
+ * @param limit 페이지 당 엔트리 수 (기본 AUTOINDEX_PAGE_LIMIT)
+ * @return true page 또는 limit 요청
+ * @return false 전체 페이지 요청
  */
-bool FileManager::DetermineFileType(const std::string& kPath,
-                                    const dirent* kEnt,
-                                    std::vector<std::string>& dir_vector,
-                                    std::vector<std::string>& file_vector) {
-  std::string file_name(kEnt->d_name);
-  if (kEnt->d_type == DT_LNK) {
-    struct stat s_buf;
-    if (stat((kPath + file_name).c_str(), &s_buf) == -1) {
-      return false;
+bool FileManager::ParseAutoindexPage(size_t& page, size_t& limit) {
+  page = 1;
+  limit = AUTOINDEX_PAGE_LIMIT;
+  bool is_paged = false;
+  std::istringstream ss(request_.req.query);
+  std::string param;
+  while (std::getline(ss, param, '&')) {
+    size_t eq_pos = param.find('=');
+    std::string key = param.substr(0, eq_pos);
+    if ((key != "page" && key != "limit") || eq_pos == std::string::npos ||
+        eq_pos + 1 >= param.size() ||
+        std::isdigit(static_cast<unsigned char>(param[eq_pos + 1])) == false) {
+      continue;
     }
-    S_ISDIR(s_buf.st_mode) ? dir_vector.push_back(file_name + "/")
-                           : file_vector.push_back(file_name);
-  } else {
-    (kEnt->d_type == DT_DIR) ? dir_vector.push_back(file_name + "/")
-                             : file_vector.push_back(file_name);
+    char* end;
+    size_t num = strtoul(param.c_str() + eq_pos + 1, &end, 10);
+    if (*end != '\0' || num == 0) {
+      continue;
+    }
+    (key == "page")
+        ? page = std::min(num, static_cast<size_t>(AUTOINDEX_PAGE_MAX))
+        : limit = std::min(num, static_cast<size_t>(AUTOINDEX_LIMIT_MAX));
+    is_paged = true;
   }
-  return true;
+  return is_paged;
 }
 
 /**
- * @brief autoindex 경로 리스트 html <a> 태그 달아서 생성
+ * @brief 페이지로 나눈 autoindex 에 이전/다음 페이지 링크 작성
  *
- * @param paths 디렉토리/파일 경로 벡터
+ * @param page 현재 페이지 번호
+ * @param limit 페이지 당 엔트리 수
+ * @param has_next 다음 페이지 존재 여부
  */
-void FileManager::ListAutoindexFiles(std::vector<std::string>& paths) {
-  std::sort(paths.begin(), paths.end());
-  for (size_t i = 0; i < paths.size(); ++i) {
-    std::string encoded_path(paths[i]);
-    UriParser().EncodeAsciiToHex(encoded_path);
-    response_content_ +=
-        "<a href='./" + encoded_path + "'>" + paths[i] + "</a>\n";
+void FileManager::AppendAutoindexNav(size_t page, size_t limit,
+                                     bool has_next) {
+  std::stringstream ss;
+  ss << "\n";
+  if (page > 1) {
+    ss << "<a href='?page=" << page - 1 << "&amp;limit=" << limit
+       << "'>&lt; prev</a> ";
   }
+  ss << "page " << page;
+  if (has_next == true) {
+    ss << " <a href='?page=" << page + 1 << "&amp;limit=" << limit
+       << "'>next &gt;</a>";
+  }
+  ss << "\n";
+  response_content_ += ss.str();
+}
+
+/**
+ * @brief 파일을 보내려고 설정한 헤더 제거, 에러 페이지는 파일과 다른 표현이므로
+ * 사이드카의 content-encoding 과 파일의 validator, Range 지원 광고를 보내지
+ * 않음 (416 의 content-range 는 유지)
+ *
+ */
+void FileManager::EraseFileHeaders(void) {
+  result_.header.erase("content-encoding");
+  result_.header.erase("etag");
+  result_.header.erase("last-modified");
+  result_.header.erase("accept-ranges");
 }
 
 /**
@@ -369,8 +1162,6 @@ ResponseManager::IoFdPair FileManager::DetermineSuccessFileExt(void) {
  */
 int FileManager::SetIoComplete(const int kStatus) {
   close(in_fd_);
-  close(out_fd_);
   in_fd_ = -1;
-  out_fd_ = -1;
   return kStatus;
 }
@@ -0,0 +1,246 @@
+/**
+ * @file FileWatcher.cpp
+ * @author ghan, jiskim, yongjule
+ * @brief Watch static content roots with kqueue and invalidate file caches
+ * @date 2022-11-25
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "FileWatcher.hpp"
+
+/**
+ * @brief 감시 중인 파일이 없는 FileWatcher 생성, 감시 fd 가 연결에 필요한 fd 를
+ * 다 쓰지 않도록 최대 감시 수를 RLIMIT_NOFILE 에 맞춤
+ *
+ */
+FileWatcher::FileWatcher(void)
+    : kq_(-1), watch_max_(FILE_WATCH_MAX), is_overflowed_(false) {
+  struct rlimit fd_limit;
+  if (getrlimit(RLIMIT_NOFILE, &fd_limit) == 0 &&
+      fd_limit.rlim_cur / FILE_WATCH_FD_SHARE < watch_max_) {
+    watch_max_ = fd_limit.rlim_cur / FILE_WATCH_FD_SHARE;
+  }
+}
+
+/**
+ * @brief 감시 fd 정리
+ *
+ */
+FileWatcher::~FileWatcher(void) {
+  for (WatchMap::iterator it = watches_.begin(); it != watches_.end(); ++it) {
+    close(it->first);
+  }
+}
+
+/**
+ * @brief root 디렉토리 아래 모든 파일/디렉토리를 EVFILT_VNODE 로 감시하고,
+ * 전부 감시되면 open file cache 가 root 아래 엔트리를 유효 시간 없이 쓰도록 등록
+ *
+ * @param kq 감시 이벤트를 등록할 kqueue
+ * @param kRoot root 디렉토리 경로
+ */
+void FileWatcher::WatchRoot(int kq, const std::string& kRoot) {
+  kq_ = kq;
+  std::string root(kRoot);
+  if (*root.rbegin() != '/') {
+    root += '/';
+  }
+  if (is_overflowed_ == true || watched_paths_.count(root) == 1) {
+    return;  // 이미 다른 root 아래에서 감시 중
+  }
+  if (AddWatch(root, true) == true && WatchDirectory(root) == true) {
+    g_open_file_cache.AddWatchedRoot(root);
+  }
+}
+
+/**
+ * @brief root 밖에 있을 수 있는 파일 하나 (에러 페이지) 감시, 삭제/이동되면 같은
+ * 경로에 새로 생긴 파일을 다시 감시
+ *
+ * @param kq 감시 이벤트를 등록할 kqueue
+ * @param kPath 파일 경로
+ */
+void FileWatcher::WatchFile(int kq, const std::string& kPath) {
+  kq_ = kq;
+  if (watched_paths_.count(kPath) == 1 || AddWatch(kPath, false) == true) {
+    pinned_paths_.insert(kPath);  // overflow 후에도 감시 유지
+  }
+}
+
+/**
+ * @brief 감시 중인 파일/디렉토리 변경 이벤트로 캐시 무효화
+ * 디렉토리에 엔트리가 추가/삭제되면 디렉토리 아래 캐시를 모두 무효화하고
+ * 새 엔트리 감시, 삭제/이동된 파일은 감시 해제
+ * 로드된 에러 페이지가 바뀌었으면 다시 로드
+ *
+ * @param kEvent EVFILT_VNODE 이벤트
+ */
+void FileWatcher::HandleEvent(const struct kevent& kEvent) {
+  WatchMap::iterator it = watches_.find(static_cast<int>(kEvent.ident));
+  if (it == watches_.end()) {
+    return;
+  }
+  if (kEvent.flags & EV_ERROR) {
+    RemoveWatch(it);
+    return Overflow("failed to receive a vnode event : " +
+                    std::string(strerror(kEvent.data)));
+  }
+  const bool kIsDir = it->second.is_dir;
+  const std::string kPath = it->second.path;
+  if (kIsDir == true) {
+    g_open_file_cache.InvalidatePrefix(kPath);
+    g_static_response_cache.InvalidatePrefix(kPath);
+    g_autoindex_cache.InvalidatePrefix(kPath);
+    g_error_page_cache.ReloadPrefix(kPath);
+  } else {
+    g_open_file_cache.Invalidate(kPath);
+    g_static_response_cache.Invalidate(kPath);
+    g_error_page_cache.Reload(kPath);
+  }
+  if (kEvent.fflags & (NOTE_DELETE | NOTE_RENAME | NOTE_REVOKE)) {
+    RemoveWatch(it);
+    if (pinned_paths_.count(kPath) == 1 && AddWatch(kPath, false) == false) {
+      pinned_paths_.erase(kPath);  // 같은 경로에 새 파일이 없음
+    }
+  } else if (kIsDir == true && (kEvent.fflags & NOTE_WRITE)) {
+    WatchDirectory(kPath);
+  }
+}
+
+// SECTION : private
+/**
+ * @brief 파일/디렉토리 하나를 EVFILT_VNODE 로 감시
+ * 감시 한도를 넘거나 (사라진 파일 제외) 감시에 실패하면 overflow 처리
+ *
+ * @param kPath 감시할 경로
+ * @param is_dir 디렉토리 여부
+ * @return true 감시 시작
+ * @return false 감시 실패
+ */
+bool FileWatcher::AddWatch(const std::string& kPath, bool is_dir) {
+  if (is_overflowed_ == true) {
+    return false;
+  }
+  if (watches_.size() >= watch_max_) {
+    Overflow("watch limit reached");
+    return false;
+  }
+  errno = 0;
+  int fd = open(kPath.c_str(), O_EVTONLY | O_CLOEXEC);
+  if (fd == -1) {
+    if (errno != ENOENT) {
+      Overflow("failed to watch " + kPath + " : " + strerror(errno));
+    }
+    return false;
+  }
+  struct kevent watch_ev;
+  EV_SET(&watch_ev, fd, EVFILT_VNODE, EV_ADD | EV_CLEAR, FILE_WATCH_FFLAGS, 0,
+         NULL);
+  if (kevent(kq_, &watch_ev, 1, NULL, 0, NULL) == -1) {
+    close(fd);
+    Overflow("failed to watch " + kPath + " : " + strerror(errno));
+    return false;
+  }
+  Watch& watch = watches_[fd];
+  watch.is_dir = is_dir;
+  watch.path = kPath;
+  watched_paths_.insert(kPath);
+  return true;
+}
+
+/**
+ * @brief 디렉토리 안의 아직 감시하지 않는 엔트리를 재귀적으로 감시
+ *
+ * @param kDir 디렉토리 경로 ('/' 로 끝남)
+ * @return true 모든 엔트리 감시 중
+ * @return false overflow
+ */
+bool FileWatcher::WatchDirectory(const std::string& kDir) {
+  DIR* dir = opendir(kDir.c_str());
+  if (dir == NULL) {
+    if (errno != ENOENT) {
+      Overflow("failed to open " + kDir + " : " + strerror(errno));
+    }
+    return is_overflowed_ == false;
+  }
+  for (dirent* ent = readdir(dir); ent != NULL && is_overflowed_ == false;
+       ent = readdir(dir)) {
+    std::string name(ent->d_name);
+    if (name == "." || name == "..") {
+      continue;
+    }
+    bool is_dir = (ent->d_type == DT_DIR);
+    if (ent->d_type == DT_LNK || ent->d_type == DT_UNKNOWN) {
+      struct stat file_stat;
+      is_dir = (stat((kDir + name).c_str(), &file_stat) == 0 &&
+                S_ISDIR(file_stat.st_mode));
+    }
+    std::string path = kDir + name + ((is_dir == true) ? "/" : "");
+    if (watched_paths_.count(path) == 0 && AddWatch(path, is_dir) == true &&
+        is_dir == true) {
+      WatchDirectory(path);
+    }
+  }
+  closedir(dir);
+  return is_overflowed_ == false;
+}
+
+/**
+ * @brief 감시 해제, 디렉토리면 아래의 감시도 모두 해제
+ * 상위 디렉토리가 감시 중이 아닌 root 가 사라지면 다시 생겨도 알 수 없으므로
+ * overflow 처리
+ *
+ * @param it 해제할 감시
+ */
+void FileWatcher::RemoveWatch(WatchMap::iterator it) {
+  const std::string kPath = it->second.path;
+  if (it->second.is_dir == false) {
+    close(it->first);
+    watched_paths_.erase(kPath);
+    watches_.erase(it);
+    return;
+  }
+  for (WatchMap::iterator watch_it = watches_.begin();
+       watch_it != watches_.end();) {
+    if (watch_it->second.path.compare(0, kPath.size(), kPath) == 0) {
+      close(watch_it->first);
+      watched_paths_.erase(watch_it->second.path);
+      watches_.erase(watch_it++);
+    } else {
+      ++watch_it;
+    }
+  }
+  size_t parent_end = kPath.rfind('/', kPath.size() - 2);
+  if (parent_end == std::string::npos ||
+      watched_paths_.count(kPath.substr(0, parent_end + 1)) == 0) {
+    Overflow("watched root " + kPath + " is removed");
+  }
+}
+
+/**
+ * @brief 변경을 더 이상 모두 감시할 수 없을 때 open file cache 가 모든
+ * 엔트리를 유효 시간 (OPEN_FILE_CACHE_VALID) 기준으로 다시 검증하도록 전환
+ * 더 쓸모 없는 root 아래 감시 fd 는 닫고, 에러 페이지 감시만 유지
+ *
+ * @param kReason 로그에 남길 원인
+ */
+void FileWatcher::Overflow(const std::string& kReason) {
+  if (is_overflowed_ == true) {
+    return;
+  }
+  PRINT_ERROR("FileWatcher : " << kReason
+                               << ", falling back to revalidation every "
+                               << OPEN_FILE_CACHE_VALID << "s");
+  is_overflowed_ = true;
+  g_open_file_cache.ClearWatchedRoots();
+  for (WatchMap::iterator it = watches_.begin(); it != watches_.end();) {
+    if (pinned_paths_.count(it->second.path) == 0) {
+      close(it->first);
+      watched_paths_.erase(it->second.path);
+      watches_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
@@ -0,0 +1,45 @@
+/**
+ * @file Gzip.cpp
+ * @author ghan, jiskim, yongjule
+ * @brief Compress response content with zlib in gzip format
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "Gzip.hpp"
+
+/**
+ * @brief 데이터를 한 번에 gzip 으로 압축, 결과 크기의 상한 (deflateBound) 만큼
+ * 미리 할당해 한 번의 deflate 로 끝냄
+ *
+ * @param kSrc 압축할 데이터
+ * @param len 압축할 데이터 크기
+ * @param level 압축 레벨 (1-9)
+ * @param dst 압축 결과
+ * @return true
+ * @return false zlib 에러
+ */
+bool Gzip::Compress(const char* kSrc, size_t len, int level, std::string& dst) {
+  z_stream stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  if (deflateInit2(&stream, level, Z_DEFLATED, GZIP_WINDOW_BITS,
+                   GZIP_MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+    return false;
+  }
+  dst.resize(deflateBound(&stream, len));
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(kSrc));
+  stream.avail_in = len;
+  stream.next_out = reinterpret_cast<Bytef*>(&dst[0]);
+  stream.avail_out = dst.size();
+  int status = deflate(&stream, Z_FINISH);
+  dst.resize(stream.total_out);
+  deflateEnd(&stream);
+  if (status != Z_STREAM_END) {
+    dst.clear();
+    return false;
+  }
+  return true;
+}
@@ -9,39 +9,175 @@
 
 #include "HeaderFormatter.hpp"
 
+time_t HeaderFormatter::date_time_ = 0;
+std::string HeaderFormatter::date_;
+std::map<int, std::string> HeaderFormatter::expires_;
+std::string
+    HeaderFormatter::status_lines_[STATUS_CODE_MAX - STATUS_CODE_MIN + 1];
+const char* HeaderFormatter::kAllowFields_[8] = {
+    "allow: " CRLF,
+    "allow: GET" CRLF,
+    "allow: POST" CRLF,
+    "allow: GET, POST" CRLF,
+    "allow: DELETE" CRLF,
+    "allow: GET, DELETE" CRLF,
+    "allow: POST, DELETE" CRLF,
+    "allow: GET, POST, DELETE" CRLF};
+
+/**
+ * @brief 모든 상태 코드의 status line 뒷부분을 미리 작성
+ *
+ */
+void HeaderFormatter::InitStatusLines(void) {
+  for (int status = STATUS_CODE_MIN; status <= STATUS_CODE_MAX; ++status) {
+    std::string& line = status_lines_[status - STATUS_CODE_MIN];
+    line.clear();
+    AppendNumber(line, status);
+    line += ' ';
+    StatusMap::const_iterator it = g_status_map.find(status);
+    if (it != g_status_map.end()) {
+      line += it->second;
+    }
+    line += CRLF;
+  }
+}
+
+/**
+ * @brief Date 헤더 필드에 들어갈 값 갱신, 초가 바뀌었을 때만 현재 시간을 RFC
+ * 규격에 맞게 formatting
+ *
+ * @param now 현재 시간
+ */
+void HeaderFormatter::UpdateDate(time_t now) {
+  if (now != date_time_ || date_.empty() == true) {
+    date_time_ = now;
+    date_ = FormatHttpDate(now);
+    expires_.clear();
+  }
+}
+
+/**
+ * @brief 이벤트 루프가 갱신한 Date 헤더 필드 값 반환
+ *
+ * @return const std::string& Formatting 된 현재 시간
+ */
+const std::string& HeaderFormatter::get_date(void) {
+  if (date_.empty() == true) {
+    UpdateDate(time(NULL));
+  }
+  return date_;
+}
+
 /**
- * @brief Date 헤더 필드에 들어갈 값 설정, 현재 시간을 RFC 규격에 에 맞게
+ * @brief Expires 헤더 필드 값 반환, 같은 초 안에서는 max-age 별로 한 번만
  * formatting
  *
- * @return std::string Formatting 된 현재 시간
+ * @param max_age 현재 시간부터 만료까지 초
+ * @return const std::string& Formatting 된 만료 시간
  */
-std::string HeaderFormatter::FormatCurrentTime(void) {
-  time_t now = time(0);
-  char buf[80];
-  struct tm gmt_time = *gmtime(&now);
-  strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", &gmt_time);
-  return buf;
+const std::string& HeaderFormatter::GetExpires(int max_age) {
+  get_date();
+  std::string& expires = expires_[max_age];
+  if (expires.empty() == true) {
+    expires = FormatHttpDate(date_time_ + max_age);
+  }
+  return expires;
 }
 
 /**
- * @brief Allowed 헤더 필드에 들어갈 값 설정, 라우팅 된 location 의 허가된
- * methods 출력
+ * @brief 미리 작성된 status line 의 상태 코드부터 CRLF 까지 반환
  *
- * @param allowed_methods 라우팅 된 location 에서 허용하는 methods
- * @return std::string GET, POST, DELETE 중 허가된 메소드 리스트
+ * @param status 응답 상태 코드
+ * @return const std::string& "<status code> <reason phrase>\r\n"
  */
-std::string HeaderFormatter::FormatAllowed(uint8_t allowed_methods) {
-  std::string methods;
-  if (allowed_methods & GET) {
-    methods += "GET";
+const std::string& HeaderFormatter::GetStatusLine(int status) {
+  if (status < STATUS_CODE_MIN || status > STATUS_CODE_MAX) {
+    status = 500;  // INTERNAL SERVER ERROR
   }
-  if (allowed_methods & POST) {
-    methods += (methods.size() > 0) ? ", POST" : "POST";
+  std::string& line = status_lines_[status - STATUS_CODE_MIN];
+  if (line.empty() == true) {
+    InitStatusLines();
   }
-  if (allowed_methods & DELETE) {
-    methods += (methods.size() > 0) ? ", DELETE" : "DELETE";
+  return line;
+}
+
+/**
+ * @brief 허용 methods 로 미리 작성된 Allow 헤더 필드 반환
+ *
+ * @param allowed_methods 라우팅 된 location 에서 허용하는 methods
+ * @return const char* "allow: <methods>\r\n"
+ */
+const char* HeaderFormatter::GetAllowField(uint8_t allowed_methods) {
+  return kAllowFields_[allowed_methods & (GET | POST | DELETE)];
+}
+
+/**
+ * @brief CGI 가 설정해도 서버 값을 쓰는 헤더 필드인지 확인
+ *
+ * @param kName 소문자 헤더 필드 이름
+ * @return true
+ * @return false
+ */
+bool HeaderFormatter::IsServerField(const std::string& kName) {
+  switch (kName.size()) {
+    case 4:
+      return kName == "date";
+    case 5:
+      return kName == "allow";
+    case 6:
+      return kName == "server";
+    case 10:
+      return kName == "connection";
+    case 14:
+      return kName == "content-length";
+    default:
+      return false;
   }
-  return methods;
+}
+
+/**
+ * @brief 10진수 숫자를 stringstream 없이 이어 붙임
+ *
+ * @param dst 이어 붙일 문자열
+ * @param num 숫자
+ */
+void HeaderFormatter::AppendNumber(std::string& dst, size_t num) {
+  char buf[24];
+  char* pos = buf + sizeof(buf);
+  do {
+    *--pos = '0' + num % 10;
+    num /= 10;
+  } while (num > 0);
+  dst.append(pos, buf + sizeof(buf) - pos);
+}
+
+/**
+ * @brief 시간을 RFC 규격의 HTTP-date (IMF-fixdate) 로 formatting
+ *
+ * @param kTime formatting 할 시간
+ * @return std::string Formatting 된 시간
+ */
+std::string HeaderFormatter::FormatHttpDate(const time_t kTime) {
+  char buf[80];
+  struct tm gmt_time = *gmtime(&kTime);
+  strftime(buf, sizeof(buf), HTTP_DATE_FORMAT, &gmt_time);
+  return buf;
+}
+
+/**
+ * @brief ETag 헤더 필드에 들어갈 값 설정, 파일의 inode, 크기, 수정 시각으로
+ * 만든 weak validator
+ *
+ * @param inode 파일 inode
+ * @param size 파일 크기
+ * @param mtime 파일 수정 시각
+ * @return std::string W/"inode-size-mtime" (16진수)
+ */
+std::string HeaderFormatter::FormatETag(ino_t inode, off_t size,
+                                        time_t mtime) {
+  std::stringstream ss;
+  ss << std::hex << "W/\"" << inode << "-" << size << "-" << mtime << "\"";
+  return ss.str();
 }
 
 /**
@@ -65,24 +201,8 @@ std::string HeaderFormatter::FormatContentType(bool is_autoindex,
     content_type = content_type_it->second;
     header.erase(content_type_it);
   } else {
-    MimeMap::iterator mime_it = g_mime_map.find(kExt);
-    content_type = (mime_it != g_mime_map.end()) ? mime_it->second : "";
+    const std::string* kType = g_mime_map.Find(kExt);
+    content_type = (kType != NULL) ? *kType : "";
   }
   return content_type;
 }
-
-/**
- * @brief CGI 와 충돌하는 헤더 필드 제거
- *
- * @param header 정리된 헤더 map
- */
-void HeaderFormatter::ResolveConflicts(ResponseHeaderMap& header) {
-  std::string server_fields[5] = {"server", "date", "allow", "connection",
-                                  "content-length"};
-  for (size_t i = 0; i < 5; ++i) {
-    ResponseHeaderMap::iterator it = header.find(server_fields[i]);
-    if (it != header.end()) {
-      header.erase(it);
-    }
-  }
-}
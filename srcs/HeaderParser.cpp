@@ -28,13 +28,18 @@ void HttpParser::SkipWhiteSpace(size_t& cursor) {
 }
 
 /**
- * @brief 요청의 header 가 끝날 때 까지 버퍼에 저장 후 길이 체크
+ * @brief 요청의 header 가 끝날 때 까지 버퍼에 저장 후 길이 체크, 버퍼에는
+ * header 까지만 복사
  *
- * @param segment client 로 부터 받은 데이터
+ * @param kBuf client 로 부터 받은 데이터
+ * @param offset 파싱 시작 위치
  */
-void HttpParser::ReceiveHeader(std::string& segment) {
+void HttpParser::ReceiveHeader(const std::string& kBuf, size_t& offset) {
   size_t ex_buf_size = header_buf_.size();
-  header_buf_.append(segment, 0, segment.size());
+  size_t end = kBuf.find(CRLF CRLF, offset);
+  size_t len = (end == std::string::npos) ? kBuf.size() - offset
+                                          : end + 4 - offset;
+  header_buf_.append(kBuf, offset, len);
   if (header_buf_.size() > 1 && header_buf_.compare(0, 2, CRLF) == 0) {
     if (result_.request.req.version == kHttp1_1) {
       UpdateStatus(400, kClose);  // BAD REQUEST
@@ -42,8 +47,11 @@ void HttpParser::ReceiveHeader(std::string& segment) {
     status_ = kClose;
     return;
   }
-  size_t pos = header_buf_.find(CRLF CRLF);
+  // 이전 segment 와 걸쳐 있는 CRLF CRLF 도 찾기 위해 이전 버퍼 끝 3 바이트부터
+  size_t pos =
+      header_buf_.find(CRLF CRLF, (ex_buf_size < 3) ? 0 : ex_buf_size - 3);
   if (pos == std::string::npos) {
+    offset += len;
     if (header_buf_.size() > HEADER_MAX) {
       UpdateStatus(400, kHDLenErr);  // BAD REQUEST
     }
@@ -56,7 +64,7 @@ void HttpParser::ReceiveHeader(std::string& segment) {
   }
   if (status_ < kComplete) {
     status_ = kContent;
-    segment.erase(0, pos - ex_buf_size + 4);
+    offset += pos + 4 - ex_buf_size;
   }
 }
 
@@ -147,13 +155,12 @@ void HttpParser::TokenizeFieldValueList(size_t& cursor, std::string& name) {
  * @param no_match_status 매칭된 값이 없을 때 설정할 HTTP 상태 (501 | 400)
  * @param delim 필드의 값들을 구분하는 구분자
  */
-void HttpParser::ParseFieldValueList(std::list<std::string>& values,
+void HttpParser::ParseFieldValueList(Fields::Values& values,
                                      std::map<std::string, size_t>& valid_map,
                                      int no_match_status, char delim) {
-  size_t list_size = values.size();
-  for (size_t i = 0; i < list_size; ++i) {
-    std::istringstream ss(values.front());
-    values.pop_front();
+  Fields::Values tokens;
+  for (size_t i = 0; i < values.size(); ++i) {
+    std::istringstream ss(values[i]);
     std::string token;
     while (std::getline(ss, token, delim)) {
       std::string::iterator token_end =
@@ -170,10 +177,11 @@ void HttpParser::ParseFieldValueList(std::list<std::string>& values,
       if (it->second > 0) {
         return UpdateStatus(400, kClose);  // BAD REQUEST
       }
-      values.push_back(token);
+      tokens.push_back(token);
       ++(it->second);
     }
   }
+  values.swap(tokens);
 }
 
 /**
@@ -182,7 +190,7 @@ void HttpParser::ParseFieldValueList(std::list<std::string>& values,
  */
 void HttpParser::ValidateHost(void) {
   Request& request = result_.request;
-  Fields::iterator it = request.header.find("host");
+  Fields::iterator it = request.header.find(Fields::kHost);
   if (it != request.header.end()) {
     if (it->second.size() != 1) {
       UpdateStatus(400, kClose);  // BAD REQUEST
@@ -209,8 +217,8 @@ void HttpParser::DetermineBodyLength(void) {
     return;
   }
   Fields& header = result_.request.header;
-  Fields::iterator cl_it = header.find("content-length");
-  Fields::iterator te_it = header.find("transfer-encoding");
+  Fields::iterator cl_it = header.find(Fields::kContentLength);
+  Fields::iterator te_it = header.find(Fields::kTransferEncoding);
   if (te_it != header.end() && cl_it != header.end()) {
     return UpdateStatus(400, kClose);  // BAD REQUEST
   }
@@ -230,7 +238,7 @@ void HttpParser::DetermineBodyLength(void) {
  *
  * @param content_length Content-Length 헤더 값
  */
-void HttpParser::ParseContentLength(std::list<std::string>& content_length) {
+void HttpParser::ParseContentLength(Fields::Values& content_length) {
   if (content_length.size() != 1 ||
       content_length.front().find_first_not_of(DIGIT) != std::string::npos) {
     return UpdateStatus(400, kClose);  // BAD REQUEST
@@ -247,7 +255,7 @@ void HttpParser::ParseContentLength(std::list<std::string>& content_length) {
  *
  * @param encodings Transfer-Encoding 헤더 값 리스트
  */
-void HttpParser::ParseTransferEncoding(std::list<std::string>& encodings) {
+void HttpParser::ParseTransferEncoding(Fields::Values& encodings) {
   std::pair<std::string, size_t> valid_codings[7] = {
       std::make_pair("chunked", 0),   std::make_pair("compress", 0),
       std::make_pair("deflate", 0),   std::make_pair("gzip", 0),
@@ -279,7 +287,7 @@ void HttpParser::ValidateConnection(void) {
   }
   keep_alive_ = result_.request.req.version;
   Fields& header = result_.request.header;
-  Fields::iterator it = header.find("connection");
+  Fields::iterator it = header.find(Fields::kConnection);
   if (it != header.end()) {
     std::map<std::string, size_t> valid_value_map =
         GenerateValidValueMap(header.begin(), header.end());
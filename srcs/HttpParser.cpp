@@ -15,33 +15,36 @@
  */
 HttpParser::HttpParser(void)
     : keep_alive_(true),
-      is_data_(kChunkSize),
+      chunk_state_(kChunkSize),
       status_(HttpParser::kLeadingCRLF),
       body_length_(0),
-      chunk_size_(0) {}
+      chunk_size_(0),
+      chunk_line_len_(0),
+      chunk_max_(CHUNK_SIZE_MAX) {}
 
 /**
- * @brief status 에 따라 파싱할 부분을 구분하여 요청 파싱
+ * @brief status 에 따라 파싱할 부분을 구분하여 요청 파싱, 버퍼를 복사하지 않고
+ * offset 부터 이어서 파싱하므로 한 버퍼에 파이프라인 된 요청들을 차례로 파싱 가능
  *
- * @param segment client 로 부터 받은 데이터
+ * @param kBuf client 로 부터 받은 데이터
+ * @param offset 파싱 시작 위치, 파싱 후 다음 요청의 시작 위치로 갱신
  * @return int 파싱 상태 및 connection close 여부
  */
-int HttpParser::Parse(std::string& segment) {
+int HttpParser::Parse(const std::string& kBuf, size_t& offset) {
   if (status_ == kLeadingCRLF) {
-    if (backup_buf_.size()) {
-      segment = backup_buf_ + segment;
-      backup_buf_.clear();
-    }
-    SkipLeadingCRLF(segment);
+    SkipLeadingCRLF(kBuf, offset);
   }
   if (status_ == kRequestLine) {
-    ReceiveRequestLine(segment);
+    ReceiveRequestLine(kBuf, offset);
   }
   if (status_ == kHeader) {
-    ReceiveHeader(segment);
+    ReceiveHeader(kBuf, offset);
   }
   if (status_ == kContent) {
-    ReceiveContent(segment);
+    ReceiveContent(kBuf, offset);
+  }
+  if (status_ >= kComplete && result_.status != 200) {
+    offset = kBuf.size();  // 에러 응답 이후 남은 데이터는 버림
   }
   if (status_ == kComplete && keep_alive_ == false) {
     status_ = kClose;
@@ -49,29 +52,19 @@ int HttpParser::Parse(std::string& segment) {
   return status_;
 }
 
-/**
- * @brief 다음 리퀘스트가 있는 지 여부 반환
- *
- * @return true
- * @return false
- */
-bool HttpParser::DoesNextReqExist(void) {
-  return (status_ == kComplete && backup_buf_.empty() == false);
-}
-
 /**
  * @brief HttpParser 객체 초기화
  *
  */
 void HttpParser::Clear(void) {
   keep_alive_ = true;
-  is_data_ = false;
+  chunk_state_ = kChunkSize;
   status_ = kLeadingCRLF;
   body_length_ = 0;
   chunk_size_ = 0;
+  chunk_line_len_ = 0;
   request_line_buf_.clear();
   header_buf_.clear();
-  chunked_buf_.clear();
   result_ = Result();
 }
 
@@ -79,10 +72,7 @@ void HttpParser::Clear(void) {
  * @brief HttpParser 객체 재설정
  *
  */
-void HttpParser::Reset(void) {
-  Clear();
-  backup_buf_.clear();
-}
+void HttpParser::Reset(void) { Clear(); }
 
 /**
  * @brief 파싱 결과 반환
@@ -91,42 +81,61 @@ void HttpParser::Reset(void) {
  */
 HttpParser::Result& HttpParser::get_result(void) { return result_; }
 
+/**
+ * @brief chunk 하나의 최대 크기 설정 (config 의 chunk_max)
+ *
+ * @param chunk_max chunk-size 최대값
+ */
+void HttpParser::set_chunk_max(size_t chunk_max) { chunk_max_ = chunk_max; }
+
 // SECTION : private
 /**
- * @brief segment 에서 첫 CRLF 제거 및 유효성 검증
+ * @brief 요청 앞의 첫 CRLF 건너뛰기 및 유효성 검증
  *
- * @param segment 클라이언트로 부터 받은 데이터
+ * @param kBuf 클라이언트로 부터 받은 데이터
+ * @param offset 파싱 시작 위치
  */
-void HttpParser::SkipLeadingCRLF(std::string& segment) {
-  if (segment.size() > 2 && segment.compare(0, 2, CRLF) == 0) {
-    segment.erase(0, 2);
+void HttpParser::SkipLeadingCRLF(const std::string& kBuf, size_t& offset) {
+  if (kBuf.size() > offset + 2 && kBuf.compare(offset, 2, CRLF) == 0) {
+    offset += 2;
   }
   status_ = kRequestLine;
-  if (isupper(segment[0]) == false) {
+  if (offset >= kBuf.size() ||
+      isupper(static_cast<unsigned char>(kBuf[offset])) == false) {
     UpdateStatus(400, kClose);  // BAD REQUEST
   }
 }
 
 /**
- * @brief Request Line 이 끝날 때 까지 이어서 버퍼에 receive
+ * @brief Request Line 이 끝날 때 까지 이어서 버퍼에 receive, 버퍼에는 Request
+ * Line 만 복사
  *
- * @param segment client 로 부터 받은 데이터
+ * @param kBuf client 로 부터 받은 데이터
+ * @param offset 파싱 시작 위치
  */
-void HttpParser::ReceiveRequestLine(std::string& segment) {
-  size_t ex_buf_size = request_line_buf_.size();
-  request_line_buf_.append(segment);
-  size_t pos = request_line_buf_.find(CRLF);
-  if (pos == std::string::npos) {
-    if (request_line_buf_.size() > REQUEST_LINE_MAX) {
-      UpdateStatus(414, kRLLenErr);  // BAD REQUEST
+void HttpParser::ReceiveRequestLine(const std::string& kBuf, size_t& offset) {
+  size_t line_end;
+  if (request_line_buf_.size() > 0 && *request_line_buf_.rbegin() == '\r' &&
+      offset < kBuf.size() && kBuf[offset] == '\n') {
+    // 이전 segment 가 CR 로 끝나고 이번 segment 가 LF 로 시작하는 경우
+    request_line_buf_.erase(request_line_buf_.size() - 1);
+    line_end = offset - 1;
+  } else {
+    line_end = kBuf.find(CRLF, offset);
+    if (line_end == std::string::npos) {
+      request_line_buf_.append(kBuf, offset, std::string::npos);
+      offset = kBuf.size();
+      if (request_line_buf_.size() > REQUEST_LINE_MAX) {
+        UpdateStatus(414, kRLLenErr);  // BAD REQUEST
+      }
+      return;
     }
-    return;
+    request_line_buf_.append(kBuf, offset, line_end - offset);
   }
-  request_line_buf_.erase(pos);
   ParseRequestLine();
   if (status_ < kComplete) {
     status_ = kHeader;
-    segment.erase(0, pos - ex_buf_size + 2);
+    offset = line_end + 2;
   }
 }
 
@@ -235,151 +244,136 @@ void HttpParser::TokenizeVersion(size_t& pos) {
  * @brief body_length_ 로 content 를 받을지 판별 후 받아야 할 경우 chunked 인지
  * 여부에 따라 content 파싱
  *
- * @param segment client 로 부터 받은 데이터
+ * @param kBuf client 로 부터 받은 데이터
+ * @param offset 파싱 시작 위치
  */
-void HttpParser::ReceiveContent(std::string& segment) {
+void HttpParser::ReceiveContent(const std::string& kBuf, size_t& offset) {
   if (body_length_ == 0) {
     status_ = kComplete;
-    if (segment.size() > 0) {
-      backup_buf_.append(segment);
-    }
     return;
   }
   if (body_length_ == CHUNKED) {
-    return DecodeChunkedContent(segment);
+    return DecodeChunkedContent(kBuf, offset);
   }
   size_t remaining_bytes = body_length_ - result_.request.content.size();
-  if (segment.size() >= remaining_bytes) {
-    if (segment.size() > remaining_bytes) {
-      backup_buf_.assign(segment, remaining_bytes);
-    }
-    result_.request.content.append(segment, 0, remaining_bytes);
+  size_t len = std::min(remaining_bytes, kBuf.size() - offset);
+  result_.request.content.append(kBuf, offset, len);
+  offset += len;
+  if (len == remaining_bytes) {
     status_ = kComplete;
-    return;
   }
-  result_.request.content.append(segment);
 }
 
 /**
- * @brief chunked content 를 디코드하여 content 에 저장
+ * @brief chunked content 를 중간 버퍼 없이 스트리밍 디코드하여 content 에
+ * 저장, 요청이 끝나면 offset 은 다음 요청의 시작 위치
  *
- * @param segment client 로 부터 받은 데이터
+ * @param kBuf client 로 부터 받은 데이터
+ * @param offset 파싱 시작 위치
  */
-void HttpParser::DecodeChunkedContent(std::string& segment) {
-  chunked_buf_.append(segment);
-  while (true) {
-    if (is_data_ == kChunkData) {
-      if (ParseChunkData() == false) {
-        return;
-      }
-    } else if (is_data_ == kChunkSize) {
-      if (ParseChunkSize() == false) {
-        return;
-      }
-    } else if (is_data_ == kChunkEnd) {
-      return ParseChunkEnd();
-    }
-    if (status_ >= kComplete) {
-      return;
+void HttpParser::DecodeChunkedContent(const std::string& kBuf, size_t& offset) {
+  while (offset < kBuf.size() && status_ < kComplete) {
+    if (chunk_state_ <= kChunkExt) {
+      offset = ParseChunkSize(kBuf, offset);
+    } else if (chunk_state_ == kChunkData) {
+      offset = ReceiveChunkData(kBuf, offset);
+    } else {
+      offset = ParseChunkDelimiter(kBuf, offset);
     }
   }
 }
 
 /**
- * @brief chunked data 파싱 및 유효성 검증
- *
- * @return true
- * @return false
- */
-bool HttpParser::ParseChunkData() {
-  if (chunked_buf_.size() < chunk_size_ + 2) {
-    return false;
-  }
-  result_.request.content.append(chunked_buf_, 0, chunk_size_);
-  if (result_.request.content.size() > BODY_MAX) {
-    UpdateStatus(413, kClose);  // REQUEST ENTITY TOO LARGE
-    return false;
-  }
-  if (chunked_buf_.compare(chunk_size_, 2, CRLF)) {
-    UpdateStatus(400, kClose);  // BAD REQUEST
-    return false;
-  }
-  chunked_buf_.erase(0, chunk_size_ + 2);
-  is_data_ = kChunkSize;
-  return true;
-}
-
-/**
- * @brief chunk size 파싱
+ * @brief chunk size 라인 파싱 (chunk-size [ BWS ";" chunk-ext ] CR),
+ * chunk extension 은 무시
  *
- * @return true
- * @return false
+ * @param kSegment client 로 부터 받은 데이터
+ * @param pos 파싱 시작 위치
+ * @return size_t 다음 파싱 위치
  */
-bool HttpParser::ParseChunkSize(void) {
-  size_t pos = chunked_buf_.find(CRLF);
-  if (pos == std::string::npos) {
-    if (chunked_buf_.size() > CHUNKED_SIZE_LINE_MAX) {
+size_t HttpParser::ParseChunkSize(const std::string& kSegment, size_t pos) {
+  for (; pos < kSegment.size(); ++pos) {
+    const unsigned char kC = kSegment[pos];
+    if (++chunk_line_len_ > CHUNKED_SIZE_LINE_MAX) {
       UpdateStatus(400, kClose);  // BAD REQUEST
+      return pos;
+    }
+    if (chunk_state_ == kChunkSize && isxdigit(kC)) {
+      chunk_size_ = chunk_size_ * 16 +
+                    (isdigit(kC) ? kC - '0' : (tolower(kC) - 'a' + 10));
+      if (chunk_size_ > chunk_max_) {
+        UpdateStatus(400, kClose);  // BAD REQUEST
+        return pos;
+      }
+    } else if (chunk_line_len_ == 1) {
+      UpdateStatus(400, kClose);  // BAD REQUEST
+      return pos;
+    } else if (kC == '\r' && chunk_state_ != kChunkSizeBWS) {
+      chunk_state_ = kChunkSizeLF;
+      return pos + 1;
+    } else if (chunk_state_ != kChunkExt) {
+      if (kC == ';') {
+        chunk_state_ = kChunkExt;
+      } else if (kC == ' ' || kC == '\t') {
+        chunk_state_ = kChunkSizeBWS;
+      } else {
+        UpdateStatus(400, kClose);  // BAD REQUEST
+        return pos;
+      }
     }
-    return false;
-  }
-  if (pos > CHUNKED_SIZE_LINE_MAX) {
-    UpdateStatus(400, kClose);  // BAD REQUEST
-    return false;
-  }
-  std::string chunk_size_line(chunked_buf_, 0, pos);
-  chunked_buf_.erase(0, pos + 2);
-  if (IgnoreChunkExtension(chunk_size_line) == false) {
-    return false;
-  }
-  std::stringstream ss(chunk_size_line);
-  ss >> std::hex >> chunk_size_;
-  if (chunk_size_ > CHUNK_SIZE_MAX) {
-    UpdateStatus(400, kClose);  // BAD REQUEST
-    return false;
   }
-  is_data_ = (chunk_size_ == 0) ? kChunkEnd : kChunkData;
-  return true;
+  return pos;
 }
 
 /**
- * @brief chunked 요청 끝났는지 확인, 끝났으면 상태 업데이트
+ * @brief chunk data 를 segment 에서 바로 content 에 저장
  *
+ * @param kSegment client 로 부터 받은 데이터
+ * @param pos chunk data 시작 위치
+ * @return size_t 다음 파싱 위치
  */
-void HttpParser::ParseChunkEnd(void) {
-  if (chunked_buf_.size() >= 2) {
-    if (chunked_buf_.compare(0, 2, CRLF)) {
-      return UpdateStatus(400, kClose);  // BAD REQUEST
-    }
-    status_ = kComplete;
-    backup_buf_.assign(chunked_buf_, 2);
+size_t HttpParser::ReceiveChunkData(const std::string& kSegment, size_t pos) {
+  size_t len = std::min(chunk_size_, kSegment.size() - pos);
+  if (result_.request.content.size() + len > BODY_MAX) {
+    UpdateStatus(413, kClose);  // REQUEST ENTITY TOO LARGE
+    return pos;
+  }
+  result_.request.content.append(kSegment, pos, len);
+  chunk_size_ -= len;
+  if (chunk_size_ == 0) {
+    chunk_state_ = kChunkDataCR;
   }
+  return pos + len;
 }
 
 /**
- * @brief chunk size 라인에서 chunk extension 있으면 지우기, chunk size HEXDIG
- * 만 있는지 검증
+ * @brief chunk size 라인, chunk data, last-chunk 뒤의 CRLF 검증 및 다음 상태
+ * 설정
  *
- * @param chunk_size_line chunk size 라인
- * @return true
- * @return false
+ * @param kSegment client 로 부터 받은 데이터
+ * @param pos CR 혹은 LF 위치
+ * @return size_t 다음 파싱 위치
  */
-bool HttpParser::IgnoreChunkExtension(std::string& chunk_size_line) {
-  size_t pos = chunk_size_line.find(";");
-  if (pos == std::string::npos) {
-    if (chunk_size_line.find_first_not_of(HEXDIG) != std::string::npos) {
-      UpdateStatus(400, kClose);  // BAD REQUEST
-      return false;
-    }
+size_t HttpParser::ParseChunkDelimiter(const std::string& kSegment,
+                                       size_t pos) {
+  const char kExpected =
+      (chunk_state_ == kChunkDataCR || chunk_state_ == kChunkEndCR) ? '\r'
+                                                                    : '\n';
+  if (kSegment[pos] != kExpected) {
+    UpdateStatus(400, kClose);  // BAD REQUEST
+    return pos;
+  }
+  if (chunk_state_ == kChunkSizeLF) {
+    chunk_state_ = (chunk_size_ == 0) ? kChunkEndCR : kChunkData;
+  } else if (chunk_state_ == kChunkDataLF) {
+    chunk_state_ = kChunkSize;
+    chunk_line_len_ = 0;
+  } else if (chunk_state_ == kChunkEndLF) {
+    status_ = kComplete;
   } else {
-    chunk_size_line.erase(pos);
-    pos = chunk_size_line.find_first_not_of(HEXDIG);
-    if (chunk_size_line.find_first_not_of(SP HTAB, pos) != std::string::npos) {
-      UpdateStatus(400, kClose);  // BAD REQUEST
-      return false;
-    }
+    ++chunk_state_;  // kChunkDataCR -> kChunkDataLF, kChunkEndCR -> kChunkEndLF
   }
-  return true;
+  return pos + 1;
 }
 
 /**
@@ -17,7 +17,8 @@
            << "], udata: [" << event.udata << "]" << std::endl;
 
 /**
- * @brief HttpServer 객체 생성, Connection vector 사이즈 max fd 개수로 설정
+ * @brief HttpServer 객체 생성, Connection vector 사이즈 max fd 개수로 설정하고
+ * open file cache 가 쓸 fd 수를 fd 한도에 맞춤
  *
  * @param kConfig 서버 설정값 구조체
  */
@@ -27,6 +28,14 @@ HttpServer::HttpServer(const ServerConfig& kConfig)
   struct rlimit fd_limit;
   getrlimit(RLIMIT_NOFILE, &fd_limit);
   connections_.resize(fd_limit.rlim_cur);
+  g_open_file_cache.FitFdLimit(fd_limit.rlim_cur);
+  g_mime_map.Add(kConfig.mime_types);
+  g_error_page_cache.RenderDefaultBodies();
+  HeaderFormatter::InitStatusLines();
+  OpenRoots();
+  if (g_disk_io_pool.Start() == false) {
+    PRINT_ERROR("HttpServer : failed to start disk I/O threads");
+  }
 }
 
 /**
@@ -37,15 +46,19 @@ HttpServer::~HttpServer() { close(kq_); }
 
 /**
  * @brief 서버 실행
- * kqueue 에 쌓인 이벤트를 종류 (소켓, file/PIPE I/O, timer)에 따라 처리
+ * kqueue 에 쌓인 이벤트를 종류 (소켓, file/PIPE I/O, timer, root 파일 변경)에
+ * 따라 처리
  *
  */
 void HttpServer::Run(void) {
   InitKqueue();
   struct kevent events[MAX_EVENTS];
+  struct timespec no_wait = {0, 0};
 
   while (true) {
-    int number_of_events = kevent(kq_, NULL, 0, events, MAX_EVENTS, NULL);
+    int number_of_events =
+        kevent(kq_, NULL, 0, events, MAX_EVENTS,
+               pipelined_fds_.empty() ? NULL : &no_wait);
     if (number_of_events == -1) {
       PRINT_ERROR("HttpServer : kevent failed : " << strerror(errno));
       for (ConnectionVector::iterator it = connections_.begin();
@@ -55,9 +68,12 @@ void HttpServer::Run(void) {
       sleep(1);
       continue;
     }
+    HeaderFormatter::UpdateDate(time(NULL));
     for (int i = 0; i < number_of_events; ++i) {
       if (events[i].filter == EVFILT_TIMER) {
         ClearConnectionResources(events[i].ident);
+      } else if (events[i].filter == EVFILT_VNODE) {
+        file_watcher_.HandleEvent(events[i]);
       } else {
         if (passive_sockets_.count(events[i].ident) == 1) {
           AcceptConnection(events[i].ident);
@@ -68,6 +84,7 @@ void HttpServer::Run(void) {
         }
       }
     }
+    ResumePipelinedRequests();
     close_io_fds_.clear();
   }
 }
@@ -85,7 +102,7 @@ void HttpServer::HandleConnectionEvent(struct kevent& event) {
   if (event.filter == EVFILT_READ) {
     ReceiveRequests(socket_fd);
   } else if (event.filter == EVFILT_WRITE) {
-    SendResponses(socket_fd);
+    SendResponses(socket_fd, event.data);
   }
   int connection_status = connections_[socket_fd].get_connection_status();
   if (connection_status == CONNECTION_ERROR) {
@@ -120,7 +137,7 @@ void HttpServer::HandleIOEvent(struct kevent& event) {
 
 // SECTION : private
 /**
- * @brief kqueue 생성 및 passive socket 등록
+ * @brief kqueue 생성 및 passive socket, static 파일 root 감시 등록
  *
  */
 void HttpServer::InitKqueue(void) {
@@ -150,6 +167,80 @@ void HttpServer::InitKqueue(void) {
     exit(EXIT_FAILURE);
   }
   delete[] sock_ev;
+  WatchRoots();
+}
+
+/**
+ * @brief 모든 서버의 location root 디렉토리를 미리 열어 두어 요청 경로를 root
+ * 기준 상대 경로로 열도록 함
+ *
+ */
+void HttpServer::OpenRoots(void) {
+  for (HostPortMap::iterator host_it = host_port_map_.begin();
+       host_it != host_port_map_.end(); ++host_it) {
+    ServerRouter& server_router = host_it->second;
+    OpenLocationRoots(server_router.default_server);
+    for (LocationRouterMap::iterator it =
+             server_router.location_router_map.begin();
+         it != server_router.location_router_map.end(); ++it) {
+      OpenLocationRoots(it->second);
+    }
+  }
+}
+
+/**
+ * @brief 서버 블록의 static 파일 location 과 CGI 블록의 root 디렉토리 열기
+ *
+ * @param location_router 서버 블록의 location 정보
+ */
+void HttpServer::OpenLocationRoots(LocationRouter& location_router) {
+  for (LocationMap::iterator it = location_router.location_map.begin();
+       it != location_router.location_map.end(); ++it) {
+    if (it->second.redirect_to.empty() == true) {
+      it->second.root_fd = g_open_file_cache.OpenRoot("." + it->second.root);
+    }
+  }
+  for (LocationRouter::CgiVector::iterator it =
+           location_router.cgi_vector.begin();
+       it != location_router.cgi_vector.end(); ++it) {
+    it->second.root_fd = g_open_file_cache.OpenRoot("." + it->second.root);
+  }
+}
+
+/**
+ * @brief 모든 서버의 location root 와 에러 페이지를 감시해 변경 시 파일 캐시
+ * 무효화 및 에러 페이지 다시 로드
+ *
+ */
+void HttpServer::WatchRoots(void) {
+  for (HostPortMap::const_iterator host_it = host_port_map_.begin();
+       host_it != host_port_map_.end(); ++host_it) {
+    const ServerRouter& kServerRouter = host_it->second;
+    WatchLocationRoots(kServerRouter.default_server);
+    for (LocationRouterMap::const_iterator it =
+             kServerRouter.location_router_map.begin();
+         it != kServerRouter.location_router_map.end(); ++it) {
+      WatchLocationRoots(it->second);
+    }
+  }
+}
+
+/**
+ * @brief 서버 블록의 에러 페이지를 메모리에 로드해 감시하고, static 파일
+ * location root 감시
+ *
+ * @param kLocationRouter 서버 블록의 location 정보
+ */
+void HttpServer::WatchLocationRoots(const LocationRouter& kLocationRouter) {
+  const std::string kErrorPath = "." + kLocationRouter.error.index;
+  g_error_page_cache.Load(kErrorPath);
+  file_watcher_.WatchFile(kq_, kErrorPath);
+  for (LocationMap::const_iterator it = kLocationRouter.location_map.begin();
+       it != kLocationRouter.location_map.end(); ++it) {
+    if (it->second.redirect_to.empty() == true) {
+      file_watcher_.WatchRoot(kq_, "." + it->second.root);
+    }
+  }
 }
 
 /**
@@ -226,27 +317,65 @@ void HttpServer::AcceptConnection(int socket_fd) {
 }
 
 /**
- * @brief Connection 소켓 fd 에 요청이 입력됐을 때 처리 및 소켓 I/O 이벤트 등록
+ * @brief Connection 소켓 fd 에 요청이 입력됐을 때 처리 및 소켓 I/O 이벤트 등록,
+ * 한 이벤트에서 처리하는 파이프라인 요청 수는 PIPELINE_REQUEST_MAX 로 제한
  *
  * @param kSocketFd 요청이 발생한 소켓 fd
  */
 void HttpServer::ReceiveRequests(const int kSocketFd) {
   Connection& connection = connections_[kSocketFd];
-  ResponseManager::IoFdPair io_fds = connection.HandleRequest();
-  if (connection.get_connection_status() == CONNECTION_ERROR) {
-    return;
+  int handled_count = 0;
+  do {
+    ResponseManager::IoFdPair io_fds = connection.HandleRequest();
+    if (connection.get_connection_status() == CONNECTION_ERROR) {
+      return;
+    }
+    if (connection.get_connection_status() == KEEP_READING) {
+      break;
+    }
+    RegisterIoEvents(io_fds, kSocketFd);
+  } while (connection.CanHandleNextRequest(++handled_count) == true);
+  if (connection.IsResponseBufferReady() == true) {
+    UpdateKqueue(kSocketFd, EVFILT_WRITE, EV_ADD | EV_ONESHOT);
   }
-  UpdateKqueue(kSocketFd, EVFILT_READ, EV_ADD | EV_ONESHOT);
-  if (connection.get_connection_status() == KEEP_READING) {
+  ResumeReceiving(kSocketFd);
+}
+
+/**
+ * @brief 응답 큐에 여유가 있으면 다음 요청 처리 재개, 버퍼에 남은 파이프라인
+ * 요청은 다음 루프에서 처리하고 없으면 recv 이벤트 등록
+ * 응답 큐가 가득 찬 경우 응답 전송 후 SendResponses 에서 재개
+ *
+ * @param kSocketFd Connection 소켓 fd
+ */
+void HttpServer::ResumeReceiving(const int kSocketFd) {
+  Connection& connection = connections_[kSocketFd];
+  if (connection.IsResponseQueueFull() == true) {
     return;
   }
-  RegisterIoEvents(io_fds, kSocketFd);
-  if (connection.IsResponseBufferReady() == true) {
-    UpdateKqueue(kSocketFd, EVFILT_WRITE, EV_ADD | EV_ONESHOT);
+  if (connection.HasPipelinedRequest() == true) {
+    pipelined_fds_.insert(kSocketFd);
+  } else {
+    UpdateKqueue(kSocketFd, EVFILT_READ, EV_ADD | EV_ONESHOT);
   }
-  while (connection.get_connection_status() == NEXT_REQUEST_EXISTS) {
-    io_fds = connection.HandleRequest();
-    RegisterIoEvents(io_fds, kSocketFd);
+}
+
+/**
+ * @brief 이전 루프에서 처리하지 못한 파이프라인 요청들을 이어서 처리
+ *
+ */
+void HttpServer::ResumePipelinedRequests(void) {
+  PipelinedFdSet pipelined_fds;
+  pipelined_fds.swap(pipelined_fds_);
+  for (PipelinedFdSet::iterator it = pipelined_fds.begin();
+       it != pipelined_fds.end(); ++it) {
+    if (connections_[*it].HasPipelinedRequest() == false) {
+      continue;
+    }
+    ReceiveRequests(*it);
+    if (connections_[*it].get_connection_status() == CONNECTION_ERROR) {
+      ClearConnectionResources(*it);
+    }
   }
 }
 
@@ -255,11 +384,13 @@ void HttpServer::ReceiveRequests(const int kSocketFd) {
  * 소켓 I/O 이벤트 등록
  *
  * @param socket_fd 요청 처리 중인 Connection 소켓 fd
+ * @param send_space 송신 버퍼 여유 공간 (EVFILT_WRITE 이벤트의 data)
  */
-void HttpServer::SendResponses(int socket_fd) {
+void HttpServer::SendResponses(int socket_fd, size_t send_space) {
   Connection& connection = connections_[socket_fd];
   if (connection.get_send_status() < SEND_FINISHED) {
-    connection.Send();
+    bool was_queue_full = connection.IsResponseQueueFull();
+    connection.Send(send_space);
     if (connection.get_connection_status() == CONNECTION_ERROR) {
       return;
     }
@@ -272,6 +403,9 @@ void HttpServer::SendResponses(int socket_fd) {
     if (connection.IsResponseBufferReady() == true) {
       UpdateKqueue(socket_fd, EVFILT_WRITE, EV_ADD | EV_ONESHOT);
     }
+    if (was_queue_full == true) {
+      ResumeReceiving(socket_fd);
+    }
   }
 }
 
@@ -319,5 +453,6 @@ void HttpServer::ClearConnectionResources(int socket_fd) {
     }
   }
   connections_[socket_fd].Clear();
+  pipelined_fds_.erase(socket_fd);
   UpdateTimerEvent(socket_fd, EV_DELETE, 0);
 }
@@ -0,0 +1,313 @@
+/**
+ * @file MimeMap.cpp
+ * @author ghan, jiskim, yongjule
+ * @brief Perfect hash table of file extensions to MIME types
+ * @date 2022-12-03
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "MimeMap.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+static const char* kDefaultTypes[][2] = {
+    {"htm", "text/html;charset=utf-8"},
+    {"html", "text/html;charset=utf-8"},
+    {"shtml", "text/html;charset=utf-8"},
+    {"md", "text/html;charset=utf-8"},
+    {"css", "text/css;charset=utf-8"},
+    {"xml", "text/xml;charset=utf-8"},
+    {"txt", "text/plain;charset=utf-8"},
+    {"mml", "text/mathml"},
+    {"jad", "text/vnd.sun.j2me.app-descriptor"},
+    {"wml", "text/vnd.wap.wml"},
+    {"htc", "text/x-component"},
+    {"gif", "image/gif"},
+    {"jpeg", "image/jpeg"},
+    {"jpg", "image/jpeg"},
+    {"js", "application/javascript"},
+    {"atom", "application/atom+xml"},
+    {"rss", "application/rss+xml"},
+    {"avif", "image/avif"},
+    {"png", "image/png"},
+    {"svg", "image/svg+xml"},
+    {"svgz", "image/svg+xml"},
+    {"tif", "image/tiff"},
+    {"tiff", "image/tiff"},
+    {"wbmp", "image/vnd.wap.wbmp"},
+    {"webp", "image/webp"},
+    {"ico", "image/x-icon"},
+    {"jng", "image/x-jng"},
+    {"bmp", "image/x-ms-bmp"},
+    {"woff", "font/woff"},
+    {"woff2", "font/woff2"},
+    {"jar", "application/java-archive"},
+    {"war", "application/java-archive"},
+    {"ear", "application/java-archive"},
+    {"json", "application/json"},
+    {"hqx", "application/mac-binhex40"},
+    {"doc", "application/msword"},
+    {"pdf", "application/pdf"},
+    {"ps", "application/postscript"},
+    {"eps", "application/postscript"},
+    {"ai", "application/postscript"},
+    {"rtf", "application/rtf"},
+    {"m3u8", "application/vnd.apple.mpegurl"},
+    {"kml", "application/vnd.google-earth.kml+xml"},
+    {"kmz", "application/vnd.google-earth.kmz"},
+    {"xls", "application/vnd.ms-excel"},
+    {"eot", "application/vnd.ms-fontobject"},
+    {"ppt", "application/vnd.ms-powerpoint"},
+    {"odg", "application/vnd.oasis.opendocument.graphics"},
+    {"odp", "application/vnd.oasis.opendocument.presentation"},
+    {"ods", "application/vnd.oasis.opendocument.spreadsheet"},
+    {"odt", "application/vnd.oasis.opendocument.text"},
+    {"pptx",
+     "application/"
+     "vnd.openxmlformats-officedocument.presentationml.presentation"},
+    {"xlsx",
+     "application/"
+     "vnd.openxmlformats-officedocument.spreadsheetml.sheet"},
+    {"docx",
+     "application/"
+     "vnd.openxmlformats-officedocument.wordprocessingml.document"},
+    {"wmlc", "application/vnd.wap.wmlc"},
+    {"wasm", "application/wasm"},
+    {"7z", "application/x-7z-compressed"},
+    {"cco", "application/x-cocoa"},
+    {"jardiff", "application/x-java-archive-diff"},
+    {"jnlp", "application/x-java-jnlp-file"},
+    {"run", "application/x-makeself"},
+    {"pl", "application/x-perl "},
+    {"pm", "application/x-perl"},
+    {"prc", "aplication/x-pilot"},
+    {"pdb", "application/x-"},
+    {"rar", "application/x-rar-compressed"},
+    {"rpm", "application/x-redhat-package-manager"},
+    {"sea", "application/x-sea"},
+    {"swf", "application/x-shockwave-flash"},
+    {"sit", "application/x-stuffit"},
+    {"tcl", "application/x-tcl"},
+    {"tk", "application/x-tcl"},
+    {"der", "aplication/x-x509-ca-cer"},
+    {"pem", "application/x-x509-ca-cert"},
+    {"crt", "application/x-x509-ca-cert"},
+    {"xpi", "application/x-xpinstall"},
+    {"xhtml", "application/xhtml+xml"},
+    {"xspf", "application/xspf+xml"},
+    {"zip", "application/zip"},
+    {"bin", "application/octet-stream"},
+    {"exe", "application/octet-stream"},
+    {"dll", "application/octet-stream"},
+    {"deb", "application/octet-stream"},
+    {"dmg", "application/octet-stream"},
+    {"iso", "application/octet-stream"},
+    {"img", "application/octet-stream"},
+    {"msi", "application/octet-stream"},
+    {"msp", "application/octet-stream"},
+    {"msm", "application/octet-stream"},
+    {"mid", "audio/midi"},
+    {"midi", "audio/midi"},
+    {"kar", "audio/midi"},
+    {"mp3", "audio/mpeg"},
+    {"ogg", "audio/ogg"},
+    {"m4a", "audio/x-m4a"},
+    {"ra", "audio/x-realaudio"},
+    {"3gpp", "video/3gpp"},
+    {"3gp", "video/3gpp"},
+    {"ts", "video/mp2t"},
+    {"mp4", "video/mp4"},
+    {"mpeg", "video/mpeg"},
+    {"mpg", "video/mpeg"},
+    {"mov", "video/quicktime"},
+    {"webm", "video/webm"},
+    {"flv", "video/x-flv"},
+    {"m4v", "video/x-m4v"},
+    {"mng", "video/x-mng"},
+    {"asx", "video/x-ms-asf"},
+    {"asf", "video/x-ms-asf"},
+    {"wmv", "video/x-ms-wmv"},
+    {"avi", "video/x-msvideo"},
+};
+
+/**
+ * @brief 기본 MIME 타입으로 테이블 빌드
+ *
+ */
+MimeMap::MimeMap(void) : mask_(0) {
+  const MimeTypeList kDefaults = GetDefaultTypes();
+  entries_.assign(kDefaults.begin(), kDefaults.end());
+  Build();
+}
+
+/**
+ * @brief 확장자의 MIME 타입 추가 후 테이블 다시 빌드, 이미 있는 확장자는
+ * 타입을 덮어씀
+ *
+ * @param kExt 파일 확장자
+ * @param kType MIME 타입
+ */
+void MimeMap::Add(const std::string& kExt, const std::string& kType) {
+  MimeTypeList types;
+  types.push_back(Entry(kExt, kType));
+  Add(types);
+}
+
+/**
+ * @brief config 의 types 블록에 정의된 MIME 타입들을 추가 후 테이블 한 번만
+ * 다시 빌드
+ *
+ * @param kTypes <확장자, MIME 타입> 리스트
+ */
+void MimeMap::Add(const MimeTypeList& kTypes) {
+  for (MimeTypeList::const_iterator it = kTypes.begin(); it != kTypes.end();
+       ++it) {
+    std::vector<Entry>::iterator entry_it = entries_.begin();
+    while (entry_it != entries_.end() && entry_it->first != it->first) {
+      ++entry_it;
+    }
+    if (entry_it != entries_.end()) {
+      entry_it->second = it->second;
+    } else {
+      entries_.push_back(*it);
+    }
+  }
+  Build();
+}
+
+/**
+ * @brief 확장자에 해당하는 MIME 타입 조회
+ *
+ * @param kExt 파일 확장자 시작 위치 ('.' 제외)
+ * @param len 확장자 길이
+ * @return const std::string* MIME 타입, 없으면 NULL
+ */
+const std::string* MimeMap::Find(const char* kExt, size_t len) const {
+  if (slots_.empty() == true) {
+    return NULL;
+  }
+  uint32_t seed = seeds_[Hash(kExt, len, 0) & mask_];
+  int idx = slots_[Hash(kExt, len, seed) & mask_];
+  if (idx == -1 || entries_[idx].first.size() != len ||
+      memcmp(entries_[idx].first.data(), kExt, len) != 0) {
+    return NULL;
+  }
+  return &entries_[idx].second;
+}
+
+/**
+ * @brief 확장자에 해당하는 MIME 타입 조회
+ *
+ * @param kExt 파일 확장자
+ * @return const std::string* MIME 타입, 없으면 NULL
+ */
+const std::string* MimeMap::Find(const std::string& kExt) const {
+  return Find(kExt.data(), kExt.size());
+}
+
+/**
+ * @brief config 의 types 블록이 없을 때 사용하는 기본 MIME 타입 목록
+ *
+ * @return MimeTypeList <확장자, MIME 타입> 리스트
+ */
+MimeTypeList MimeMap::GetDefaultTypes(void) {
+  const size_t kCount = sizeof(kDefaultTypes) / sizeof(kDefaultTypes[0]);
+  MimeTypeList types;
+  types.reserve(kCount);
+  for (size_t i = 0; i < kCount; ++i) {
+    types.push_back(Entry(kDefaultTypes[i][0], kDefaultTypes[i][1]));
+  }
+  return types;
+}
+
+// SECTION : private
+/**
+ * @brief 충돌 없이 배치될 때 까지 테이블 크기를 늘리며 perfect hash 빌드
+ * 테이블 크기는 엔트리 수의 2 배 이상인 2 의 거듭제곱
+ *
+ */
+void MimeMap::Build(void) {
+  uint32_t size = 1;
+  while (size < entries_.size() * 2) {
+    size <<= 1;
+  }
+  while (Place(size - 1) == false) {
+    size <<= 1;
+  }
+}
+
+/**
+ * @brief 1 차 해시로 엔트리를 bucket 에 나누고, 큰 bucket 부터 모든 엔트리가
+ * 빈 slot 에 들어가는 displacement seed 를 찾아 배치 (hash and displace)
+ *
+ * @param mask 테이블 크기 - 1
+ * @return true 배치 성공
+ * @return false seed 를 찾지 못한 bucket 이 있음
+ */
+bool MimeMap::Place(uint32_t mask) {
+  std::vector<std::vector<int> > buckets(mask + 1);
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    const std::string& kExt = entries_[i].first;
+    buckets[Hash(kExt.data(), kExt.size(), 0) & mask].push_back(i);
+  }
+  std::vector<std::pair<size_t, uint32_t> > order;  // <크기, bucket>
+  for (uint32_t b = 0; b <= mask; ++b) {
+    if (buckets[b].empty() == false) {
+      order.push_back(std::make_pair(buckets[b].size(), b));
+    }
+  }
+  std::sort(order.rbegin(), order.rend());
+  std::vector<uint32_t> seeds(mask + 1, 0);
+  std::vector<int> slots(mask + 1, -1);
+  std::vector<uint32_t> placed;
+  for (size_t i = 0; i < order.size(); ++i) {
+    const std::vector<int>& kBucket = buckets[order[i].second];
+    uint32_t seed = 1;
+    for (; seed < MIME_SEED_MAX; ++seed) {
+      placed.clear();
+      size_t j = 0;
+      for (; j < kBucket.size(); ++j) {
+        const std::string& kExt = entries_[kBucket[j]].first;
+        uint32_t slot = Hash(kExt.data(), kExt.size(), seed) & mask;
+        if (slots[slot] != -1 ||
+            std::find(placed.begin(), placed.end(), slot) != placed.end()) {
+          break;
+        }
+        placed.push_back(slot);
+      }
+      if (j == kBucket.size()) {
+        break;
+      }
+    }
+    if (seed == MIME_SEED_MAX) {
+      return false;
+    }
+    seeds[order[i].second] = seed;
+    for (size_t j = 0; j < kBucket.size(); ++j) {
+      slots[placed[j]] = kBucket[j];
+    }
+  }
+  seeds_.swap(seeds);
+  slots_.swap(slots);
+  mask_ = mask;
+  return true;
+}
+
+/**
+ * @brief seed 를 섞은 FNV-1a 해시
+ *
+ * @param kKey 해시할 문자열
+ * @param len 문자열 길이
+ * @param seed 해시 seed
+ * @return uint32_t 해시 값
+ */
+uint32_t MimeMap::Hash(const char* kKey, size_t len, uint32_t seed) {
+  uint32_t hash = 2166136261u ^ (seed * 0x9e3779b9u);
+  for (size_t i = 0; i < len; ++i) {
+    hash ^= static_cast<unsigned char>(kKey[i]);
+    hash *= 16777619u;
+  }
+  return hash ^ (hash >> 15);
+}
@@ -0,0 +1,411 @@
+/**
+ * @file OpenFileCache.cpp
+ * @author ghan, jiskim, yongjule
+ * @brief LRU cache of open file descriptors and stat results for static files
+ * @date 2022-11-23
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "OpenFileCache.hpp"
+
+/**
+ * @brief 빈 캐시 생성
+ *
+ */
+OpenFileCache::OpenFileCache(void) : capacity_(OPEN_FILE_CACHE_MAX) {}
+
+/**
+ * @brief 캐시가 가진 fd 와 root 디렉토리 fd 정리
+ *
+ */
+OpenFileCache::~OpenFileCache(void) {
+  Clear();
+  for (RootFdMap::iterator it = root_fds_.begin(); it != root_fds_.end();
+       ++it) {
+    close(it->second);
+  }
+}
+
+/**
+ * @brief 캐시된 fd 가 연결과 감시에 필요한 fd 를 다 쓰지 않도록 최대 엔트리 수를
+ * fd 한도의 OPEN_FILE_CACHE_FD_SHARE 분의 1 로 제한, 넘치는 엔트리는 제거
+ *
+ * @param fd_limit RLIMIT_NOFILE soft limit
+ */
+void OpenFileCache::FitFdLimit(rlim_t fd_limit) {
+  capacity_ = OPEN_FILE_CACHE_MAX;
+  if (fd_limit / OPEN_FILE_CACHE_FD_SHARE < capacity_) {
+    capacity_ = fd_limit / OPEN_FILE_CACHE_FD_SHARE;
+  }
+  while (entries_.size() > capacity_) {
+    Erase(entries_.find(lru_.back()));
+  }
+}
+
+/**
+ * @brief 경로의 열린 fd 와 stat 정보 반환, 캐시에 있고 유효하면 시스템 콜 없이
+ * 반환하며 없거나 OPEN_FILE_CACHE_VALID 초가 지났으면 다시 open 후 캐시
+ * 감시 중인 root 아래의 엔트리는 FileWatcher 가 무효화할 때 까지 유효
+ * FILE_NOCACHE_MIN 이상인 파일은 캐시하지 않고 이번 요청만 쓰는 fd 에
+ * F_NOCACHE 를 설정해 반환 (자주 쓰이는 파일들을 page cache 에서 밀어내지 않음)
+ * 반환된 fd 는 사용 후 Release 로 반납
+ *
+ * @param kPath 파일 경로
+ * @param root_fd 경로가 속한 root 디렉토리 fd (OpenRoot)
+ * @param root_len kPath 중 root_fd 가 가리키는 부분의 길이
+ * @return OpenFileCache::Info 파일 정보
+ */
+OpenFileCache::Info OpenFileCache::Open(const std::string& kPath, int root_fd,
+                                        size_t root_len) {
+  EntryMap::iterator it = entries_.find(kPath);
+  if (it != entries_.end() && IsValid(it, time(NULL)) == true) {
+    lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+    return Acquire(it->second.info);
+  }
+  Info info = Load(kPath, root_fd, root_len);
+  if (IsCacheable(info) == false) {
+    if (it != entries_.end()) {
+      Erase(it);
+    }
+    if (info.size >= FILE_NOCACHE_MIN) {
+      fcntl(info.fd, F_NOCACHE, 1);
+    }
+    return info;  // 캐시되지 않은 fd, Release 에서 바로 close
+  }
+  Store(kPath, info);
+  return Acquire(info);
+}
+
+/**
+ * @brief 경로가 캐시에 있고 유효해서 Open 이 시스템 콜 없이 끝나는지 확인
+ *
+ * @param kPath 파일 경로
+ * @return true
+ * @return false
+ */
+bool OpenFileCache::IsFresh(const std::string& kPath) {
+  EntryMap::iterator it = entries_.find(kPath);
+  return (it != entries_.end() && IsValid(it, time(NULL)) == true);
+}
+
+/**
+ * @brief Load 한 파일 정보를 캐시에 저장, 기존 엔트리는 교체하고 fd 는 캐시가
+ * 참조를 가짐 (작업 스레드에서 Load 한 결과도 이벤트 루프에서 저장)
+ * 저장할 수 없는 파일 (IsCacheable) 은 fd 를 닫음, 요청이 Open 으로 다시 열
+ * 때는 작업 스레드의 open 으로 경로 정보가 이미 커널 캐시에 있음
+ *
+ * @param kPath 파일 경로
+ * @param kInfo Load 로 받은 파일 정보
+ */
+void OpenFileCache::Store(const std::string& kPath, const Info& kInfo) {
+  EntryMap::iterator it = entries_.find(kPath);
+  if (it != entries_.end()) {
+    Erase(it);
+  }
+  if (kInfo.err == EMFILE || kInfo.err == ENFILE) {
+    return;  // 일시적인 에러는 캐시하지 않음
+  }
+  if (IsCacheable(kInfo) == false) {
+    Release(kInfo.fd);
+    return;
+  }
+  if (entries_.size() >= capacity_) {
+    Erase(entries_.find(lru_.back()));
+  }
+  lru_.push_front(kPath);
+  Entry& entry = entries_[kPath];
+  entry.info = kInfo;
+  entry.validated = time(NULL);
+  entry.lru_it = lru_.begin();
+  if (kInfo.fd != -1) {
+    fd_refs_[kInfo.fd] = 1;  // 캐시의 참조
+  }
+}
+
+/**
+ * @brief Open 으로 받은 fd 반납, 캐시에서 빠졌고 더 쓰는 곳이 없으면 close
+ * 캐시되지 않은 fd 는 바로 close
+ *
+ * @param fd 반납할 fd
+ */
+void OpenFileCache::Release(int fd) {
+  if (fd == -1) {
+    return;
+  }
+  FdRefMap::iterator it = fd_refs_.find(fd);
+  if (it == fd_refs_.end()) {
+    close(fd);
+    return;
+  }
+  if (--it->second == 0) {
+    close(fd);
+    fd_refs_.erase(it);
+  }
+}
+
+/**
+ * @brief 경로의 캐시 엔트리 제거 (파일 생성/삭제/변경 시)
+ *
+ * @param kPath 파일 경로
+ */
+void OpenFileCache::Invalidate(const std::string& kPath) {
+  EntryMap::iterator it = entries_.find(kPath);
+  if (it != entries_.end()) {
+    Erase(it);
+  }
+}
+
+/**
+ * @brief 경로가 kPrefix 로 시작하는 캐시 엔트리 모두 제거 (디렉토리 변경 시)
+ *
+ * @param kPrefix 디렉토리 경로
+ */
+void OpenFileCache::InvalidatePrefix(const std::string& kPrefix) {
+  EntryMap::iterator it = entries_.lower_bound(kPrefix);
+  while (it != entries_.end() &&
+         it->first.compare(0, kPrefix.size(), kPrefix) == 0) {
+    Erase(it++);
+  }
+}
+
+/**
+ * @brief 모든 캐시 엔트리 제거
+ *
+ */
+void OpenFileCache::Clear(void) {
+  while (entries_.empty() == false) {
+    Erase(entries_.begin());
+  }
+}
+
+/**
+ * @brief FileWatcher 가 변경을 감시하는 root 추가, root 아래 엔트리는 유효
+ * 시간이 지나도 다시 open 하지 않음
+ *
+ * @param kRoot 감시 중인 root 디렉토리 경로
+ */
+void OpenFileCache::AddWatchedRoot(const std::string& kRoot) {
+  watched_roots_.push_back(kRoot);
+}
+
+/**
+ * @brief 감시 root 모두 제거, 감시를 유지할 수 없을 때 모든 엔트리가 유효
+ * 시간 기준으로 다시 검증됨
+ *
+ */
+void OpenFileCache::ClearWatchedRoots(void) { watched_roots_.clear(); }
+
+/**
+ * @brief location root 디렉토리를 한 번 열어 fd 반환, 같은 root 는 fd 공유
+ * 요청 경로를 이 fd 기준 상대 경로로 열면 커널이 root 까지의 경로를 매번 다시
+ * 따라가지 않음
+ *
+ * @param kRoot root 디렉토리 경로
+ * @return int root 디렉토리 fd, 열 수 없으면 AT_FDCWD (현재 디렉토리 기준)
+ */
+int OpenFileCache::OpenRoot(const std::string& kRoot) {
+  RootFdMap::iterator it = root_fds_.find(kRoot);
+  if (it != root_fds_.end()) {
+    return it->second;
+  }
+  int fd = open(kRoot.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd == -1) {
+    return AT_FDCWD;
+  }
+  root_fds_[kRoot] = fd;
+  return fd;
+}
+
+/**
+ * @brief 파일 open 후 fstat, 디렉토리면 fd 는 닫고 stat 정보만 반환
+ * open 실패 시 errno 저장, 디렉토리 여부는 stat 으로 확인
+ * 파일은 처음부터 끝까지 읽으므로 read-ahead 를 켬 (실패해도 힌트일 뿐이므로
+ * 무시)
+ * root 디렉토리 fd 가 있으면 그 아래 상대 경로만 따라가서 open
+ * 캐시 상태를 건드리지 않으므로 작업 스레드에서 호출해도 안전
+ *
+ * @param kPath 파일 경로
+ * @param root_fd 경로가 속한 root 디렉토리 fd (OpenRoot)
+ * @param root_len kPath 중 root_fd 가 가리키는 부분의 길이
+ * @return OpenFileCache::Info 파일 정보
+ */
+OpenFileCache::Info OpenFileCache::Load(const std::string& kPath, int root_fd,
+                                        size_t root_len) {
+  Info info;
+  struct stat file_stat;
+  const char* kRelPath = GetRelativePath(kPath, root_len);
+  int flags = O_RDONLY | O_CLOEXEC;
+  if (root_fd != AT_FDCWD) {
+    flags |= ROOT_RESOLVE_FLAGS;
+  }
+  errno = 0;
+  int fd = openat(root_fd, kRelPath, flags);
+  if (fd == -1 || fstat(fd, &file_stat) == -1) {
+    info.err = errno;
+    if (fd != -1) {
+      close(fd);
+    }
+    info.is_dir = (fstatat(root_fd, kRelPath, &file_stat, 0) == 0 &&
+                   S_ISDIR(file_stat.st_mode));
+    return info;
+  }
+  info.is_dir = S_ISDIR(file_stat.st_mode);
+  info.size = file_stat.st_size;
+  info.mtime = file_stat.st_mtime;
+  info.inode = file_stat.st_ino;
+  if (info.is_dir == true) {
+    close(fd);
+    return info;
+  }
+  info.fd = fd;
+  fcntl(fd, F_RDAHEAD, 1);
+  return info;
+}
+
+/**
+ * @brief autoindex 로 나열할 디렉토리를 Load 와 같이 root 디렉토리 fd 기준
+ * 상대 경로로 open, root 밖으로 벗어나는 경로는 열지 않음
+ * 캐시 상태를 건드리지 않으므로 작업 스레드에서 호출해도 안전
+ *
+ * @param kPath 디렉토리 경로
+ * @param root_fd 경로가 속한 root 디렉토리 fd (OpenRoot)
+ * @param root_len kPath 중 root_fd 가 가리키는 부분의 길이
+ * @return int 디렉토리 fd, 실패 시 -1
+ */
+int OpenFileCache::OpenDir(const std::string& kPath, int root_fd,
+                           size_t root_len) {
+  int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+  if (root_fd != AT_FDCWD) {
+    flags |= ROOT_RESOLVE_FLAGS;
+  }
+  return openat(root_fd, GetRelativePath(kPath, root_len), flags);
+}
+
+/**
+ * @brief root 디렉토리 fd 기준으로 열 상대 경로 반환
+ *
+ * @param kPath 파일 경로
+ * @param root_len kPath 중 root 디렉토리 부분의 길이, 0 이면 kPath 그대로
+ * @return const char* 상대 경로, root 자체면 "."
+ */
+const char* OpenFileCache::GetRelativePath(const std::string& kPath,
+                                           size_t root_len) {
+  if (root_len == 0) {
+    return kPath.c_str();
+  }
+  return (root_len < kPath.size()) ? kPath.c_str() + root_len : ".";
+}
+
+/**
+ * @brief offset 부터 len 바이트를 다 채우거나 EOF 를 만날 때 까지 읽음, 일반
+ * 파일은 readiness 를 기다릴 필요가 없으므로 짧게 읽혀도 바로 이어서 읽음
+ *
+ * @param fd 읽을 파일
+ * @param buf 읽은 내용을 저장할 버퍼
+ * @param len 읽을 바이트 수
+ * @param offset 읽기 시작할 파일 위치
+ * @return ssize_t 읽은 바이트 수, len 보다 작으면 EOF, 에러 시 -1
+ */
+ssize_t OpenFileCache::ReadFull(int fd, char* buf, size_t len, off_t offset) {
+  size_t read_len = 0;
+  while (read_len < len) {
+    ssize_t read_bytes =
+        pread(fd, buf + read_len, len - read_len, offset + read_len);
+    if (read_bytes == -1 && errno == EINTR) {
+      continue;
+    }
+    if (read_bytes == -1) {
+      return -1;
+    }
+    if (read_bytes == 0) {
+      break;
+    }
+    read_len += read_bytes;
+  }
+  return read_len;
+}
+
+/**
+ * @brief 곧 읽을 파일 영역을 커널이 미리 읽어 두도록 요청 (F_RDADVISE),
+ * 힌트이므로 실패해도 무시
+ *
+ * @param fd 읽을 파일
+ * @param offset 미리 읽을 파일 위치
+ * @param len 미리 읽을 바이트 수
+ */
+void OpenFileCache::AdviseRead(int fd, off_t offset, size_t len) {
+  struct radvisory advice;
+  advice.ra_offset = offset;
+  advice.ra_count = len;
+  fcntl(fd, F_RDADVISE, &advice);
+}
+
+// SECTION : private
+/**
+ * @brief 경로가 감시 중인 root 아래에 있는지 확인
+ *
+ * @param kPath 파일 경로
+ * @return true
+ * @return false
+ */
+bool OpenFileCache::IsWatched(const std::string& kPath) const {
+  for (RootVector::const_iterator it = watched_roots_.begin();
+       it != watched_roots_.end(); ++it) {
+    if (kPath.compare(0, it->size(), *it) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief 캐시 엔트리가 아직 유효한지 확인, OPEN_FILE_CACHE_VALID 초가 지나지
+ * 않았거나 감시 중인 root 아래면 유효
+ *
+ * @param it 확인할 엔트리
+ * @param now 현재 시간
+ * @return true
+ * @return false
+ */
+bool OpenFileCache::IsValid(EntryMap::iterator it, time_t now) const {
+  return (now - it->second.validated < OPEN_FILE_CACHE_VALID ||
+          IsWatched(it->first) == true);
+}
+
+/**
+ * @brief 반환할 fd 의 참조 수 증가
+ *
+ * @param kInfo 반환할 파일 정보
+ * @return OpenFileCache::Info 파일 정보
+ */
+OpenFileCache::Info OpenFileCache::Acquire(const Info& kInfo) {
+  if (kInfo.fd != -1) {
+    ++fd_refs_[kInfo.fd];
+  }
+  return kInfo;
+}
+
+/**
+ * @brief 파일 정보를 캐시에 저장할 수 있는지 확인, fd 한도 때문에 캐시가 꺼져
+ * 있거나 FILE_NOCACHE_MIN 이상인 파일이면 저장하지 않음
+ *
+ * @param kInfo Load 로 받은 파일 정보
+ * @return true
+ * @return false
+ */
+bool OpenFileCache::IsCacheable(const Info& kInfo) const {
+  return (capacity_ > 0 &&
+          (kInfo.fd == -1 || kInfo.size < FILE_NOCACHE_MIN));
+}
+
+/**
+ * @brief 캐시 엔트리 제거 및 캐시의 fd 참조 반납
+ *
+ * @param it 제거할 엔트리
+ */
+void OpenFileCache::Erase(EntryMap::iterator it) {
+  Release(it->second.info.fd);
+  lru_.erase(it->second.lru_it);
+  entries_.erase(it);
+}
@@ -23,7 +23,6 @@ ResponseManager::ResponseManager(bool is_keep_alive,
                                  Request& request)
     : is_keep_alive_(is_keep_alive),
       io_status_(IO_START),
-      err_fd_(-1),
       file_size_(0),
       result_(router_result.status),
       request_(request),
@@ -31,45 +30,43 @@ ResponseManager::ResponseManager(bool is_keep_alive,
       response_buffer_(response_buffer) {}
 
 /**
- * @brief ResponseManager 객체 소멸, 에러 페이지 fd close
+ * @brief ResponseManager 객체 소멸
  *
  */
-ResponseManager::~ResponseManager(void) { close(err_fd_); }
+ResponseManager::~ResponseManager(void) {}
 
 /**
- * @brief HTTP 규격에 맞게 응답 헤더 작성
+ * @brief HTTP 규격에 맞게 응답 헤더 작성, 캐시된 응답이면 요청마다 바뀌는
+ * 앞부분만 작성하고 나머지는 캐시된 blob 으로 전송
+ * 메모리에 만든 content 는 content-length 를 정하기 전에 압축 설정에 따라 압축
  *
  */
 void ResponseManager::FormatHeader(void) {
-  const int kStatus = result_.status;
-  std::stringstream ss;
-  ss << (request_.req.version == HttpParser::kHttp1_1 ? "HTTP/1.1 "
-                                                      : "HTTP/1.0 ")
-     << kStatus << " " << g_status_map[kStatus] << CRLF
-     << "server: BrilliantServer/1.0" << CRLF
-     << "date: " + header_formatter_.FormatCurrentTime() << CRLF
-     << ((kStatus == 301 || kStatus == 400 || kStatus == 404 || kStatus >= 500)
-             ? ""
-             : ("allow: " +
-                header_formatter_.FormatAllowed(router_result_.methods) + CRLF))
-     << "connection: "
-     << ((kStatus < 500 && is_keep_alive_ == true) ? "keep-alive" : "close")
-     << CRLF << "content-length: " << response_buffer_.content.size() << CRLF;
-  std::string content_type = header_formatter_.FormatContentType(
-      result_.is_autoindex, result_.ext, result_.header);
-  if (content_type.empty() == false) {
-    ss << "content-type: " << content_type << CRLF;
+  if (response_buffer_.cached == NULL && response_buffer_.file_fd == -1 &&
+      response_buffer_.autoindex_stream == NULL) {
+    CompressContent();
   }
-  if (result_.location.empty() == false) {  // 201 || 301 || 302
-    ss << "location: " << result_.location << CRLF;
+  const int kStatus = result_.status;
+  std::string& header = response_buffer_.header;
+  header.clear();
+  header.reserve(HEADER_RESERVE);
+  header += (request_.req.version == HttpParser::kHttp1_1) ? "HTTP/1.1 "
+                                                           : "HTTP/1.0 ";
+  header += HeaderFormatter::GetStatusLine(kStatus);
+  header += "server: BrilliantServer/1.0" CRLF "date: ";
+  header += HeaderFormatter::get_date();
+  header += (kStatus < 500 && is_keep_alive_ == true)
+                ? CRLF "connection: keep-alive" CRLF
+                : CRLF "connection: close" CRLF;
+  if (router_result_.cache->expires >= 0 && IsCacheable() == true) {
+    header += "expires: ";
+    header += HeaderFormatter::GetExpires(router_result_.cache->expires);
+    header += CRLF;
   }
-  header_formatter_.ResolveConflicts(result_.header);
-  for (ResponseHeaderMap::const_iterator it = result_.header.begin();
-       it != result_.header.end(); ++it) {
-    ss << it->first << ": " << it->second << CRLF;
+  if (response_buffer_.cached == NULL) {
+    AppendInvariantHeader(header, response_buffer_.content.size() +
+                                      response_buffer_.file_size);
   }
-  ss << CRLF;
-  response_buffer_.header = ss.str();
   response_buffer_.is_complete = true;
 }
 
@@ -106,64 +103,210 @@ ResponseManager::Result& ResponseManager::get_result(void) { return result_; }
 
 // SECTION : protected
 /**
- * @brief GET 요청/에러일 때 파일 읽기
- *
- * @param fd 파일 fd
- * @return ssize_t read 한 byte 수
- */
-ssize_t ResponseManager::ReadFile(int fd) {
-  char read_buf[READ_BUFF_SIZE + 1];
-  memset(read_buf, 0, READ_BUFF_SIZE + 1);
-  ssize_t read_bytes = read(fd, read_buf, READ_BUFF_SIZE);
-  if (read_bytes > 0) {
-    response_buffer_.content.append(read_buf, read_bytes);
-    if (read_bytes < READ_BUFF_SIZE ||
-        response_buffer_.content.size() == static_cast<size_t>(file_size_)) {
-      io_status_ = SetIoComplete(IO_COMPLETE);
-    } else {
-      io_status_ = (io_status_ < ERROR_START) ? FILE_READ : ERROR_READ;
+ * @brief 응답 헤더 중 요청마다 바뀌지 않는 allow 부터 헤더 끝 CRLF 까지 dst
+ * 뒤에 이어 붙임, CGI 가 설정한 서버 헤더 필드는 건너뜀
+ *
+ * @param dst 헤더를 이어 붙일 버퍼
+ * @param content_length content-length 헤더 값
+ */
+void ResponseManager::AppendInvariantHeader(std::string& dst,
+                                            size_t content_length) {
+  const int kStatus = result_.status;
+  if (kStatus != 301 && kStatus != 400 && kStatus != 404 && kStatus < 500) {
+    dst += HeaderFormatter::GetAllowField(router_result_.methods);
+  }
+  if (response_buffer_.autoindex_stream != NULL) {  // 길이를 모름
+    dst += "transfer-encoding: chunked" CRLF;
+  } else if (kStatus != 304) {  // 304 는 content 없이 validator 만 전송
+    dst += "content-length: ";
+    HeaderFormatter::AppendNumber(dst, content_length);
+    dst += CRLF;
+  }
+  if (kStatus != 304) {
+    std::string content_type = header_formatter_.FormatContentType(
+        result_.is_autoindex, result_.ext, result_.header);
+    if (content_type.empty() == false) {
+      dst += "content-type: ";
+      dst += content_type;
+      dst += CRLF;
     }
-    return read_bytes;
   }
-  if (read_bytes == -1) {
-    response_buffer_.content.clear();
-    result_.status = 500;  // INTERNAL SERVER ERROR
-    return -1;
+  if (result_.location.empty() == false) {  // 201 || 301 || 302
+    dst += "location: ";
+    dst += result_.location;
+    dst += CRLF;
   }
-  io_status_ = SetIoComplete(IO_COMPLETE);
-  return read_bytes;
+  if (IsCacheable() == true) {
+    dst += router_result_.cache->header;
+  }
+  for (ResponseHeaderMap::const_iterator it = result_.header.begin();
+       it != result_.header.end(); ++it) {
+    if (HeaderFormatter::IsServerField(it->first) == true) {
+      continue;
+    }
+    dst += it->first;
+    dst += ": ";
+    dst += it->second;
+    dst += CRLF;
+  }
+  dst += CRLF;
 }
 
 /**
- * @brief 상태 코드에 따라 에러 페이지 응답 생성
+ * @brief location 의 expires, cache_control 로 캐시 헤더를 붙일 응답인지 확인,
+ * CGI 가 Cache-Control 이나 Expires 를 직접 설정했으면 그 값을 따름
  *
- * @return ResponseManager::IoFdPair <에러 페이지 fd, -1> / <-1, -1>
+ * @return true
+ * @return false
  */
-ResponseManager::IoFdPair ResponseManager::GetErrorPage(void) {
-  is_keep_alive_ = (result_.status < 500);
-  const char* kErrorPath = router_result_.error_path.c_str();
-  if (access(kErrorPath, F_OK) == -1) {
-    return GenerateDefaultError();
+bool ResponseManager::IsCacheable(void) {
+  switch (result_.status) {
+    case 200:
+    case 201:
+    case 204:
+    case 206:
+    case 301:
+    case 302:
+    case 303:
+    case 304:
+    case 307:
+    case 308:
+      return (result_.header.count("cache-control") == 0 &&
+              result_.header.count("expires") == 0);
+    default:
+      return false;
   }
-  struct stat st;
-  if (stat(kErrorPath, &st) == -1 || S_ISDIR(st.st_mode) == true) {
-    return HandleGetErrorFailure();
+}
+
+/**
+ * @brief 응답이 location 의 gzip 설정으로 압축할 대상인지 확인, 압축할 MIME
+ * 타입이면 클라이언트에 따라 응답이 달라지므로 Vary 추가
+ *
+ * @param len 압축 전 content 크기
+ * @return true
+ * @return false
+ */
+bool ResponseManager::IsCompressible(size_t len) {
+  const GzipOption* kGzip = router_result_.gzip;
+  if (kGzip == NULL || kGzip->is_on == false || result_.status != 200 ||
+      result_.header.count("content-encoding") == 1 ||
+      kGzip->types.count(DetermineMimeType()) == 0) {
+    return false;
   }
-  file_size_ = st.st_size;
-  if (io_status_ == ERROR_START || io_status_ == IO_START) {
-    err_fd_ = open(kErrorPath, O_RDONLY);
-    if (err_fd_ == -1) {
-      return HandleGetErrorFailure();
+  AddVaryAcceptEncoding();
+  return (len >= kGzip->min_length && AcceptsEncoding("gzip") == true);
+}
+
+/**
+ * @brief 메모리에 만든 content (autoindex, CGI 출력 등) 를 gzip 으로 압축
+ *
+ */
+void ResponseManager::CompressContent(void) {
+  std::string& content = response_buffer_.content;
+  if (IsCompressible(content.size()) == false) {
+    return;
+  }
+  std::string compressed;
+  if (Gzip().Compress(content.data(), content.size(),
+                      router_result_.gzip->level, compressed) == true) {
+    content.swap(compressed);
+    result_.header["content-encoding"] = "gzip";
+  }
+}
+
+/**
+ * @brief Accept-Encoding 에서 content-coding 을 받는지 확인, q=0 이면 거부로
+ * 처리하고 직접 나열되지 않았으면 '*' 를 따름
+ *
+ * @param kCoding 확인할 content-coding (소문자)
+ * @return true
+ * @return false
+ */
+bool ResponseManager::AcceptsEncoding(const std::string& kCoding) {
+  Fields::iterator it = request_.header.find(Fields::kAcceptEncoding);
+  if (it == request_.header.end()) {
+    return false;
+  }
+  int wildcard = -1;  // -1: 없음, 0: 거부, 1: 허용
+  for (size_t i = 0; i < it->second.size(); ++i) {
+    std::istringstream ss(it->second[i]);
+    std::string element;
+    while (std::getline(ss, element, ',')) {
+      element.erase(std::remove_if(element.begin(), element.end(),
+                                   IsCharSet(SP HTAB, true)),
+                    element.end());
+      std::transform(element.begin(), element.end(), element.begin(),
+                     ::tolower);
+      size_t semicolon = element.find(';');
+      std::string coding = element.substr(0, semicolon);
+      size_t q_pos = element.find(";q=", semicolon);
+      bool is_accepted = (semicolon == std::string::npos ||
+                          q_pos == std::string::npos ||
+                          strtod(element.c_str() + q_pos + 3, NULL) > 0);
+      if (coding == kCoding) {
+        return is_accepted;
+      }
+      if (coding == "*") {
+        wildcard = is_accepted;
+      }
     }
-    fcntl(err_fd_, F_SETFL, O_NONBLOCK);
-    io_status_ = ERROR_READ;
   }
-  if (io_status_ == ERROR_READ && ReadFile(err_fd_) == -1) {
-    return HandleGetErrorFailure();
+  return (wildcard == 1);
+}
+
+/**
+ * @brief Vary 헤더에 Accept-Encoding 추가, CGI 가 설정한 값은 유지
+ *
+ */
+void ResponseManager::AddVaryAcceptEncoding(void) {
+  std::string& vary = result_.header["vary"];
+  if (vary.find("Accept-Encoding") == std::string::npos) {
+    vary += (vary.empty() == true) ? "Accept-Encoding" : ", Accept-Encoding";
+  }
+}
+
+/**
+ * @brief 응답 content 의 MIME 타입 (파라미터 제외, 소문자) 판별
+ *
+ * @return std::string MIME 타입, 모르면 빈 문자열
+ */
+std::string ResponseManager::DetermineMimeType(void) {
+  std::string type;
+  ResponseHeaderMap::iterator it = result_.header.find("content-type");
+  if (result_.is_autoindex == true) {
+    type = "text/html";
+  } else if (it != result_.header.end()) {
+    type = it->second;
+  } else {
+    const std::string* kType = g_mime_map.Find(result_.ext);
+    type = (kType != NULL) ? *kType : "";
   }
-  if (io_status_ == ERROR_READ) {
-    return IoFdPair(err_fd_, -1);
+  type.erase(std::remove_if(type.begin(), type.end(), IsCharSet(SP HTAB, true)),
+             type.end());
+  type = type.substr(0, type.find(';'));
+  std::transform(type.begin(), type.end(), type.begin(), ::tolower);
+  return type;
+}
+
+/**
+ * @brief 상태 코드에 따라 에러 페이지 응답 생성, 에러 페이지는 서버 시작 시
+ * 메모리에 로드한 내용을 사용해 파일 I/O 없이 응답
+ *
+ * @return ResponseManager::IoFdPair <-1, -1>
+ */
+ResponseManager::IoFdPair ResponseManager::GetErrorPage(void) {
+  is_keep_alive_ = (result_.status < 500);
+  const ErrorPageCache::Page* kPage =
+      g_error_page_cache.Find(router_result_.error_path);
+  if (kPage == NULL || kPage->err == ENOENT || kPage->err == ENOTDIR) {
+    return GenerateDefaultError();
   }
+  if (kPage->err != 0) {
+    return HandleGetErrorFailure();
+  }
+  file_size_ = kPage->content.size();
+  response_buffer_.content = kPage->content;
+  io_status_ = SetIoComplete(IO_COMPLETE);
   result_.ext = ParseExtension(router_result_.error_path);
   return IoFdPair();
 }
@@ -188,16 +331,12 @@ std::string ResponseManager::ParseExtension(const std::string& kPath) {
 }
 
 /**
- * @brief  I/O 작업 완료 상태 설정 및 fd close
+ * @brief  I/O 작업 완료 상태 설정
  *
  * @param status I/O 작업 상태
  * @return int 설정하는 io_status_
  */
-int ResponseManager::SetIoComplete(int status) {
-  close(err_fd_);
-  err_fd_ = -1;
-  return status;
-}
+int ResponseManager::SetIoComplete(int status) { return status; }
 
 // SECTION : private
 /**
@@ -214,16 +353,12 @@ ResponseManager::IoFdPair ResponseManager::HandleGetErrorFailure(void) {
 }
 
 /**
- * @brief 에러 페이지가 없을 경우 기본 에러 페이지 작성
+ * @brief 에러 페이지가 없을 경우 미리 작성된 기본 에러 페이지 사용
  *
  * @return IoFdPair <-1, -1>
  */
 ResponseManager::IoFdPair ResponseManager::GenerateDefaultError(void) {
-  std::stringstream ss;
-  ss << result_.status << " " << g_status_map[result_.status];
-  response_buffer_.content = "<!DOCTYPE html><title>" + ss.str() +
-                             "</title><body><h1>" + ss.str() +
-                             "</h1></body></html>";
+  response_buffer_.content = g_error_page_cache.GetDefaultBody(result_.status);
   router_result_.error_path = "default_error.html";
   io_status_ = SetIoComplete(IO_COMPLETE);
   result_.ext = "html";
@@ -10,6 +10,43 @@
 #include "Router.hpp"
 
 // SECTION : Location
+/**
+ * @brief 응답 압축 설정 생성, 기본 값은 off / level 1 / 256 바이트 이상 /
+ * text/html
+ *
+ */
+GzipOption::GzipOption(void)
+    : is_on(false), level(GZIP_LEVEL), min_length(GZIP_MIN_LENGTH) {
+  types.insert("text/html");
+}
+
+/**
+ * @brief 응답 캐시 설정 생성, 기본 값은 캐시 헤더 없음
+ *
+ */
+CacheOption::CacheOption(void) : expires(-1) {}
+
+const CacheOption CacheOption::kOff;
+
+/**
+ * @brief expires, cache_control 디렉티브로 Cache-Control 헤더 필드를 한 번
+ * 작성해 두어 요청마다 이어 붙이기만 하도록 함
+ *
+ */
+void CacheOption::Render(void) {
+  std::stringstream ss;
+  if (expires >= 0) {
+    ss << "max-age=" << expires;
+  }
+  if (cache_control.empty() == false) {
+    ss << (expires >= 0 ? ", " : "") << cache_control;
+  }
+  header = ss.str();
+  if (header.empty() == false) {
+    header = "cache-control: " + header + CRLF;
+  }
+}
+
 /**
  * @brief Validator 가 검증한 Config 파일에서 가져온 Location 블록 정보 담는
  * Location 객체 생성
@@ -18,7 +55,12 @@
 Location::Location(void)
     : error(false),
       autoindex(false),
+      autoindex_sort(true),
+      sendfile(true),
+      gzip_static(false),
+      brotli_static(false),
       methods(GET),
+      root_fd(AT_FDCWD),
       body_max(INT_MAX),
       root("/"),
       index(""),
@@ -32,7 +74,14 @@ Location::Location(void)
  * @param error_path
  */
 Location::Location(bool is_error, std::string error_path)
-    : error(is_error), methods(GET), index(error_path) {}
+    : error(is_error),
+      autoindex_sort(true),
+      sendfile(true),
+      gzip_static(false),
+      brotli_static(false),
+      methods(GET),
+      root_fd(AT_FDCWD),
+      index(error_path) {}
 
 // SECTION : LocationRouter
 /**
@@ -40,7 +89,11 @@ Location::Location(bool is_error, std::string error_path)
  * 저장하는 LocationRouter 객체 생성
  *
  */
-LocationRouter::LocationRouter(void) : error(true, "/error.html") {}
+LocationRouter::LocationRouter(void)
+    : chunk_max(CHUNK_SIZE_MAX),
+      send_budget(SEND_BUDGET),
+      tcp_nopush(false),
+      error(true, "/error.html") {}
 
 /**
  * @brief LocationRouter 객체 안에 저장된 location 블록 정보 중 요청의 path와
@@ -166,6 +219,12 @@ void Router::RouteToLocation(Result& result, LocationRouter& location_router,
   std::pair<Location&, size_t> location_data = location_router[req.path];
   Location& location = location_data.first;
   result.methods = location.methods;
+  result.autoindex_sort = location.autoindex_sort;
+  result.sendfile = location.sendfile;
+  result.gzip_static = location.gzip_static;
+  result.brotli_static = location.brotli_static;
+  result.gzip = &location.gzip;
+  result.cache = &location.cache;
   if (location.error == true) {
     return UpdateStatus(result, 404);  // Page Not Found
   }
@@ -184,6 +243,7 @@ void Router::RouteToLocation(Result& result, LocationRouter& location_router,
       "." + location.root +
       ((req.method == POST) ? location.upload_path.substr(1) : "") +
       req.path.substr(location_data.second);
+  SetRoot(result, location);
   if (*result.success_path.rbegin() == '/') {
     if (req.method & (POST | DELETE)) {
       return UpdateStatus(result, 403);  // Forbidden
@@ -209,6 +269,8 @@ void Router::RouteToCgi(Result& result, Request& request,
   const std::string& kCgiExt = kCgiDiscriminator.first.first;
   const Location& kCgiLocation = kCgiDiscriminator.first.second;
   result.methods = kCgiLocation.methods;
+  result.gzip = &kCgiLocation.gzip;
+  result.cache = &kCgiLocation.cache;
   if ((kCgiLocation.methods & request.req.method) == 0) {
     return UpdateStatus(result, 405);  // Method Not Allowed
   }
@@ -218,6 +280,7 @@ void Router::RouteToCgi(Result& result, Request& request,
   result.success_path =
       "." + kCgiLocation.root +
       request.req.path.substr(1, kCgiDiscriminator.second + kCgiExt.size() - 1);
+  SetRoot(result, kCgiLocation);
   if (result.cgi_env.SetMetaVariables(request, kCgiLocation.root, kCgiExt,
                                       kConnectionInfo) == false) {
     result.status = 500;  // INTERNAL SERVER ERROR
@@ -250,6 +313,19 @@ bool Router::GetHostAddr(ConnectionInfo& connection_info) const {
   return true;
 }
 
+/**
+ * @brief success_path 를 location root 디렉토리 fd 기준으로 열 수 있도록 설정
+ * success_path 는 "." + root 로 시작하므로 그 뒤가 root 기준 상대 경로
+ *
+ * @param result Router 의 결과
+ * @param kLocation success_path 를 만든 location
+ */
+void Router::SetRoot(Result& result, const Location& kLocation) {
+  result.root_fd = kLocation.root_fd;
+  result.root_len =
+      (kLocation.root_fd == AT_FDCWD) ? 0 : kLocation.root.size() + 1;
+}
+
 /**
  * @brief 에러시 HTTP 상태 업데이트 및 에러 페이지 경로 설정
  *
@@ -259,4 +335,6 @@ bool Router::GetHostAddr(ConnectionInfo& connection_info) const {
 void Router::UpdateStatus(Result& result, int status) {
   result.success_path = result.error_path;
   result.status = status;
+  result.root_fd = AT_FDCWD;
+  result.root_len = 0;
 }
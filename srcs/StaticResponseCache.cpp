@@ -0,0 +1,154 @@
+/**
+ * @file StaticResponseCache.cpp
+ * @author ghan, jiskim, yongjule
+ * @brief Memory-budgeted LRU cache of small static responses
+ * @date 2022-11-24
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include "StaticResponseCache.hpp"
+
+/**
+ * @brief 빈 캐시 생성
+ *
+ */
+StaticResponseCache::StaticResponseCache(void) : used_(0) {}
+
+/**
+ * @brief 캐시된 응답 정리
+ *
+ */
+StaticResponseCache::~StaticResponseCache(void) { Clear(); }
+
+/**
+ * @brief 경로의 캐시된 응답 반환, 파일 크기/mtime/inode 가 바뀌었거나 다른
+ * location 의 allow, cache-control, vary, 압축 수준으로 만든 응답이면 캐시에서
+ * 제거 후 NULL 반환
+ * 반환된 응답은 사용 후 Release 로 반납
+ *
+ * @param kPath 파일 경로
+ * @param methods 요청을 처리하는 location 의 허용 method
+ * @param kCacheHeader 요청을 처리하는 location 의 cache-control 헤더 필드
+ * @param kVary 요청을 처리하는 location 의 설정으로 정한 vary 값
+ * @param gzip_level 압축한 응답이면 location 의 gzip_comp_level, 아니면 0
+ * @param size 현재 파일 크기
+ * @param mtime 현재 파일 수정 시각
+ * @param inode 현재 파일 inode
+ * @return CachedResponse* 캐시된 응답, 없으면 NULL
+ */
+CachedResponse* StaticResponseCache::Find(const std::string& kPath,
+                                          uint8_t methods,
+                                          const std::string& kCacheHeader,
+                                          const std::string& kVary,
+                                          int gzip_level, off_t size,
+                                          time_t mtime, ino_t inode) {
+  EntryMap::iterator it = entries_.find(kPath);
+  if (it == entries_.end()) {
+    return NULL;
+  }
+  CachedResponse* response = it->second.response;
+  if (response->size != size || response->mtime != mtime ||
+      response->inode != inode || response->methods != methods ||
+      response->cache_header != kCacheHeader || response->vary != kVary ||
+      response->gzip_level != gzip_level) {
+    Erase(it);
+    return NULL;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+  ++response->refs;
+  return response;
+}
+
+/**
+ * @brief 새로 만든 응답을 캐시에 추가, 메모리 한도를 넘으면 오래 쓰이지 않은
+ * 응답부터 제거
+ * 캐시와 호출자가 응답을 하나씩 참조하며 호출자는 사용 후 Release 로 반납
+ *
+ * @param kPath 파일 경로
+ * @param response new 로 할당한 응답
+ * @return CachedResponse* 인자로 받은 응답
+ */
+CachedResponse* StaticResponseCache::Insert(const std::string& kPath,
+                                            CachedResponse* response) {
+  EntryMap::iterator old_it = entries_.find(kPath);
+  if (old_it != entries_.end()) {
+    Erase(old_it);
+  }
+  while (lru_.empty() == false &&
+         used_ + response->blob.size() > STATIC_CACHE_BUDGET) {
+    Erase(entries_.find(lru_.back()));
+  }
+  lru_.push_front(kPath);
+  Entry& entry = entries_[kPath];
+  entry.response = response;
+  entry.lru_it = lru_.begin();
+  used_ += response->blob.size();
+  ++response->refs;
+  return response;
+}
+
+/**
+ * @brief 응답 참조 반납, 캐시에서 빠졌고 더 쓰는 곳이 없으면 해제
+ *
+ * @param response 반납할 응답
+ */
+void StaticResponseCache::Release(CachedResponse* response) {
+  if (response != NULL && --response->refs == 0) {
+    delete response;
+  }
+}
+
+/**
+ * @brief 경로의 캐시된 응답 제거 (파일 생성/삭제/변경 시), "<경로>\0" 로
+ * 시작하는 키로 캐시된 압축 응답도 함께 제거
+ *
+ * @param kPath 파일 경로
+ */
+void StaticResponseCache::Invalidate(const std::string& kPath) {
+  EntryMap::iterator it = entries_.lower_bound(kPath);
+  if (it != entries_.end() && it->first == kPath) {
+    Erase(it++);
+  }
+  while (it != entries_.end() && it->first.size() > kPath.size() &&
+         it->first.compare(0, kPath.size(), kPath) == 0 &&
+         it->first[kPath.size()] == '\0') {
+    Erase(it++);
+  }
+}
+
+/**
+ * @brief 경로가 kPrefix 로 시작하는 캐시된 응답 모두 제거 (디렉토리 변경 시)
+ *
+ * @param kPrefix 디렉토리 경로
+ */
+void StaticResponseCache::InvalidatePrefix(const std::string& kPrefix) {
+  EntryMap::iterator it = entries_.lower_bound(kPrefix);
+  while (it != entries_.end() &&
+         it->first.compare(0, kPrefix.size(), kPrefix) == 0) {
+    Erase(it++);
+  }
+}
+
+/**
+ * @brief 모든 캐시된 응답 제거
+ *
+ */
+void StaticResponseCache::Clear(void) {
+  while (entries_.empty() == false) {
+    Erase(entries_.begin());
+  }
+}
+
+// SECTION : private
+/**
+ * @brief 캐시 엔트리 제거 및 캐시의 응답 참조 반납
+ *
+ * @param it 제거할 엔트리
+ */
+void StaticResponseCache::Erase(EntryMap::iterator it) {
+  used_ -= it->second.response->blob.size();
+  Release(it->second.response);
+  lru_.erase(it->second.lru_it);
+  entries_.erase(it);
+}
@@ -44,22 +44,22 @@ bool UriParser::ParseHost(std::string& uri) {
 }
 
 /**
- * @brief ASCII 문자 HEX 로 인코딩
+ * @brief ASCII 문자 HEX 로 인코딩해 encoded 뒤에 이어 붙임
  *
- * @param path 인코딩 적용할 경로
+ * @param kPath 인코딩 적용할 경로
+ * @param encoded 인코딩 결과를 이어 붙일 문자열
  */
-void UriParser::EncodeAsciiToHex(std::string& path) {
+void UriParser::EncodeAsciiToHex(const std::string& kPath,
+                                 std::string& encoded) {
+  const char* kHexDigits = "0123456789abcdef";
   IsCharSet is_reserved(RESERVED, true);
-  for (size_t i = 0; i < path.size(); ++i) {
-    if (is_reserved(path[i]) == true) {
-      std::stringstream ss;
-      ss << std::hex << (int)path[i];
-      std::string hex = ss.str();
-      if (hex.size() == 1) {
-        hex = "0" + hex;
-      }
-      path.replace(i, 1, "%" + hex);
-      i += 2;
+  for (size_t i = 0; i < kPath.size(); ++i) {
+    if (is_reserved(kPath[i]) == true) {
+      encoded += '%';
+      encoded += kHexDigits[(kPath[i] >> 4) & 0xf];
+      encoded += kHexDigits[kPath[i] & 0xf];
+    } else {
+      encoded += kPath[i];
     }
   }
 }
@@ -29,6 +29,15 @@ ServerConfig Validator::Validate(void) {
   for (cursor_ = std::find_if(kConfig_.begin(), kConfig_.end(),
                               IsCharSet(" \n\t", false));
        cursor_ != kConfig_.end();) {
+    if (std::string(cursor_, cursor_ + 7).compare("types {") == 0) {
+      cursor_ = std::find_if(cursor_ + 7, kConfig_.end(),
+                             IsCharSet(" \t", false));
+      cursor_ = CheckEndOfParameter(cursor_);
+      ValidateTypes(result.mime_types);
+      cursor_ =
+          std::find_if(++cursor_, kConfig_.end(), IsCharSet(" \n\t", false));
+      continue;
+    }
     if (std::string(cursor_, cursor_ + 8).compare("server {")) {
       throw SyntaxErrorException("server block not found");
     }
@@ -61,6 +70,9 @@ void Validator::InitializeKeyMap(ServerKeyMap_& key_map) const {
   key_map["listen"] = kListen;
   key_map["server_name"] = kServerName;
   key_map["error"] = kError;
+  key_map["chunk_max"] = kChunkMax;
+  key_map["send_budget"] = kSendBudget;
+  key_map["tcp_nopush"] = kTcpNopush;
   key_map["location"] = kRoute;
   key_map["cgi"] = kCgiRoute;
 }
@@ -75,11 +87,21 @@ void Validator::InitializeKeyMap(RouteKeyMap_& key_map,
                                  ServerDirective is_cgi) const {
   if (is_cgi == kRoute) {
     key_map["autoindex"] = kAutoindex;
+    key_map["autoindex_sort"] = kAutoindexSort;
+    key_map["sendfile"] = kSendfile;
+    key_map["gzip_static"] = kGzipStatic;
+    key_map["brotli_static"] = kBrotliStatic;
     key_map["redirect_to"] = kRedirectTo;
     key_map["index"] = kIndex;
   }
   key_map["methods"] = kMethods;
   key_map["body_max"] = kBodyMax;
+  key_map["gzip"] = kGzip;
+  key_map["gzip_types"] = kGzipTypes;
+  key_map["gzip_min_length"] = kGzipMinLength;
+  key_map["gzip_comp_level"] = kGzipCompLevel;
+  key_map["expires"] = kExpires;
+  key_map["cache_control"] = kCacheControl;
   key_map["root"] = kRoot;
   key_map["upload_path"] = kUploadPath;
 }
@@ -239,6 +261,85 @@ uint8_t Validator::TokenizeMethods(ConstIterator_& delim,
   return flag;
 }
 
+/**
+ * @brief Location 의 gzip_types 디렉티브의 파라미터 (MIME 타입 리스트) 파싱 &
+ * 유효성 검사
+ *
+ * @param delim 파라미터 종료 위치 가리킬 레퍼런스, 파싱 후 개행 위치로 설정
+ * @return std::set<std::string> 압축할 MIME 타입 집합
+ */
+std::set<std::string> Validator::TokenizeMimeTypes(ConstIterator_& delim) {
+  std::set<std::string> types;
+  for (; cursor_ != kConfig_.end() && *cursor_ != '\n';
+       cursor_ = std::find_if(delim, kConfig_.end(), IsCharSet(" \t", false))) {
+    delim = std::find_if(cursor_, kConfig_.end(), IsCharSet(" \t\n", true));
+    std::string type(cursor_, delim);
+    size_t slash = type.find('/');
+    if (slash == 0 || slash == std::string::npos || slash == type.size() - 1) {
+      throw SyntaxErrorException(type + " is not a MIME type");
+    }
+    std::transform(type.begin(), type.end(), type.begin(), ::tolower);
+    types.insert(type);
+  }
+  return types;
+}
+
+/**
+ * @brief Location 의 expires 디렉티브의 파라미터 파싱 & 유효성 검사, 초 단위
+ * 숫자 뒤에 s, m, h, d 단위를 붙일 수 있음
+ *
+ * @param delim 파라미터 종료 위치 가리킬 레퍼런스, 파싱 후 개행 위치로 설정
+ * @return int max-age 초, off 면 -1
+ */
+int Validator::TokenizeExpires(ConstIterator_& delim) {
+  std::string expires = TokenizeSingleString(delim);
+  if (expires == "off") {
+    return -1;
+  }
+  size_t unit_pos = expires.find_first_not_of(DIGIT);
+  size_t digits = std::min(unit_pos, expires.size());
+  if (digits == 0 || digits > 9 || digits + 1 < expires.size()) {
+    throw SyntaxErrorException("invalid expires time");
+  }
+  int64_t seconds = atoi(expires.substr(0, unit_pos).c_str());
+  if (unit_pos != std::string::npos) {
+    const std::string kUnits = "smhd";
+    const int64_t kScale[] = {1, 60, 3600, 86400};
+    size_t unit = kUnits.find(expires[unit_pos]);
+    if (unit == std::string::npos) {
+      throw SyntaxErrorException("invalid expires time");
+    }
+    seconds *= kScale[unit];
+  }
+  if (seconds > INT_MAX) {
+    throw SyntaxErrorException("expires is too large");
+  }
+  return seconds;
+}
+
+/**
+ * @brief 개행 전까지의 파라미터 전체를 하나의 문자열로 파싱, 뒤쪽 공백 제외
+ *
+ * @param delim 파라미터 종료 위치 가리킬 레퍼런스, 파싱 후 개행 위치로 설정
+ * @return const std::string 파라미터 문자열
+ */
+const std::string Validator::TokenizeLine(ConstIterator_& delim) {
+  delim = std::find(cursor_, kConfig_.end(), '\n');
+  if (delim == kConfig_.end()) {
+    throw SyntaxErrorException("expected a newline but was [EOF]");
+  }
+  std::string line(cursor_, delim);
+  line.erase(line.find_last_not_of(" \t") + 1);
+  if (line.empty() == true) {
+    throw SyntaxErrorException("empty parameter");
+  }
+  if (std::find_if(line.begin(), line.end(), IsCharSet(VCHAR SP HTAB, false)) !=
+      line.end()) {
+    throw SyntaxErrorException(line + " has an invalid character");
+  }
+  return line;
+}
+
 /**
  * @brief 파라미터 파싱 후 delim 를 개행 위치로 이동
  *
@@ -321,6 +422,35 @@ bool Validator::SwitchDirectivesToParseParam(ConstIterator_& delim,
       key_map.erase(key_it->first);
       break;
     }
+    case kChunkMax: {
+      uint32_t num = TokenizeNumber(delim);
+      if (num == 0 || num > BODY_MAX) {
+        throw SyntaxErrorException(
+            "chunk_max must be in a range, 1-134217728");
+      }
+      location_router.chunk_max = num;
+      key_map.erase(key_it->first);
+      break;
+    }
+    case kSendBudget: {
+      uint32_t num = TokenizeNumber(delim);
+      if (num < SEND_BUFF_SIZE || num > BODY_MAX) {
+        throw SyntaxErrorException(
+            "send_budget must be in a range, 32768-134217728");
+      }
+      location_router.send_budget = num;
+      key_map.erase(key_it->first);
+      break;
+    }
+    case kTcpNopush: {
+      std::string tcp_nopush = TokenizeSingleString(delim);
+      if (tcp_nopush != "on" && tcp_nopush != "off") {
+        throw SyntaxErrorException("tcp_nopush must be on or off");
+      }
+      location_router.tcp_nopush = (tcp_nopush == "on");
+      key_map.erase(key_it->first);
+      break;
+    }
     case kRoute:
       if (!location_router.location_map
                .insert(ValidateLocation(delim, key_it->second))
@@ -371,6 +501,66 @@ bool Validator::SwitchDirectivesToParseParam(ConstIterator_& delim,
       location.autoindex = (autoindex == "on");
       break;
     }
+    case kAutoindexSort: {
+      std::string autoindex_sort = TokenizeSingleString(delim);
+      if (autoindex_sort != "on" && autoindex_sort != "off")
+        throw SyntaxErrorException("autoindex_sort must be on or off");
+      location.autoindex_sort = (autoindex_sort == "on");
+      break;
+    }
+    case kSendfile: {
+      std::string sendfile = TokenizeSingleString(delim);
+      if (sendfile != "on" && sendfile != "off")
+        throw SyntaxErrorException("sendfile must be on or off");
+      location.sendfile = (sendfile == "on");
+      break;
+    }
+    case kGzipStatic: {
+      std::string gzip_static = TokenizeSingleString(delim);
+      if (gzip_static != "on" && gzip_static != "off")
+        throw SyntaxErrorException("gzip_static must be on or off");
+      location.gzip_static = (gzip_static == "on");
+      break;
+    }
+    case kBrotliStatic: {
+      std::string brotli_static = TokenizeSingleString(delim);
+      if (brotli_static != "on" && brotli_static != "off")
+        throw SyntaxErrorException("brotli_static must be on or off");
+      location.brotli_static = (brotli_static == "on");
+      break;
+    }
+    case kGzip: {
+      std::string gzip = TokenizeSingleString(delim);
+      if (gzip != "on" && gzip != "off")
+        throw SyntaxErrorException("gzip must be on or off");
+      location.gzip.is_on = (gzip == "on");
+      break;
+    }
+    case kGzipTypes:
+      location.gzip.types = TokenizeMimeTypes(delim);
+      break;
+    case kExpires:
+      location.cache.expires = TokenizeExpires(delim);
+      break;
+    case kCacheControl:
+      location.cache.cache_control = TokenizeLine(delim);
+      break;
+    case kGzipMinLength: {
+      uint32_t num = TokenizeNumber(delim);
+      if (num > INT_MAX) {
+        throw SyntaxErrorException("gzip_min_length is too large");
+      }
+      location.gzip.min_length = num;
+      break;
+    }
+    case kGzipCompLevel: {
+      uint32_t num = TokenizeNumber(delim);
+      if (num < 1 || num > 9) {
+        throw SyntaxErrorException("gzip_comp_level must be in a range, 1-9");
+      }
+      location.gzip.level = num;
+      break;
+    }
     case kBodyMax: {
       uint32_t num = TokenizeNumber(delim);
       if (num > INT_MAX) {
@@ -466,9 +656,49 @@ LocationNode Validator::ValidateLocation(ConstIterator_& delim,
     throw SyntaxErrorException();
   }
   delim = CheckEndOfParameter(delim);
+  location.cache.Render();
   return LocationNode(path, location);
 }
 
+/**
+ * @brief types 블록 파싱 및 검증, 한 줄에 MIME 타입 하나와 확장자들을 공백으로
+ * 구분해 나열
+ *
+ * @param mime_types 파싱한 <확장자, MIME 타입> 을 추가할 리스트
+ */
+void Validator::ValidateTypes(MimeTypeList& mime_types) {
+  ConstIterator_ delim;
+  for (cursor_ = std::find_if(cursor_, kConfig_.end(),
+                              IsCharSet(" \n\t", false));
+       cursor_ != kConfig_.end() && *cursor_ != '}';
+       cursor_ = std::find_if(delim, kConfig_.end(),
+                              IsCharSet(" \n\t", false))) {
+    delim = std::find_if(cursor_, kConfig_.end(), IsCharSet(" \t\n", true));
+    std::string type(cursor_, delim);
+    size_t slash = type.find('/');
+    if (slash == 0 || slash == std::string::npos || slash == type.size() - 1) {
+      throw SyntaxErrorException(type + " is not a MIME type");
+    }
+    cursor_ = std::find_if(delim, kConfig_.end(), IsCharSet(" \t", false));
+    if (cursor_ == kConfig_.end() || *cursor_ == '\n') {
+      throw SyntaxErrorException(type + " has no extension");
+    }
+    for (; cursor_ != kConfig_.end() && *cursor_ != '\n';
+         cursor_ = std::find_if(delim, kConfig_.end(),
+                                IsCharSet(" \t", false))) {
+      delim = std::find_if(cursor_, kConfig_.end(), IsCharSet(" \t\n", true));
+      std::string ext(cursor_, delim);
+      if (ext.find_first_of("/.{}") != std::string::npos) {
+        throw SyntaxErrorException(ext + " is not a file extension");
+      }
+      mime_types.push_back(std::make_pair(ext, type));
+    }
+  }
+  if (cursor_ == kConfig_.end()) {
+    throw SyntaxErrorException("invalid types block");
+  }
+}
+
 /**
  * @brief HostPortMap 에 host:port 별 ServerMap 저장
  *
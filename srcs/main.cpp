@@ -7,14 +7,27 @@
  * @copyright Copyright (c) 2022
  */
 
+#include <sys/resource.h>
+
+#include <climits>
 #include <fstream>
 
+#include "AutoindexCache.hpp"
+#include "DiskIoPool.hpp"
+#include "ErrorPageCache.hpp"
 #include "HttpServer.hpp"
+#include "OpenFileCache.hpp"
 #include "ResponseData.hpp"
+#include "StaticResponseCache.hpp"
 #include "Validator.hpp"
 
 StatusMap g_status_map;
 MimeMap g_mime_map;
+OpenFileCache g_open_file_cache;
+StaticResponseCache g_static_response_cache;
+AutoindexCache g_autoindex_cache;
+ErrorPageCache g_error_page_cache;
+DiskIoPool g_disk_io_pool;
 
 static std::string FileToString(const std::string& kFilePath) {
   std::ifstream ifs(kFilePath);
@@ -26,11 +39,34 @@ static std::string FileToString(const std::string& kFilePath) {
   return ss.str();
 }
 
+/**
+ * @brief fd soft limit 을 hard limit 까지 올림 (macOS 기본 256), 연결과 캐시된
+ * fd, 감시 fd 가 모두 들어갈 수 있도록 서버 생성 전에 호출
+ *
+ */
+static void RaiseFdLimit(void) {
+  struct rlimit fd_limit;
+  if (getrlimit(RLIMIT_NOFILE, &fd_limit) == -1) {
+    return;
+  }
+  rlim_t target = fd_limit.rlim_max;
+#ifdef OPEN_MAX
+  if (target > OPEN_MAX) {
+    target = OPEN_MAX;  // macOS 는 OPEN_MAX 를 넘는 soft limit 거부
+  }
+#endif
+  if (target > fd_limit.rlim_cur) {
+    fd_limit.rlim_cur = target;
+    setrlimit(RLIMIT_NOFILE, &fd_limit);
+  }
+}
+
 int main(int argc, char* argv[]) {
   std::string config_path((argc < 2) ? "./default.config" : argv[1]);
 
   signal(SIGPIPE, SIG_IGN);
   signal(SIGCHLD, SIG_IGN);
+  RaiseFdLimit();
 
   size_t last_dot = config_path.rfind('.');
   if (config_path.size() < 8 || last_dot == std::string::npos ||
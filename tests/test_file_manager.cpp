@@ -0,0 +1,543 @@
+/**
+ * @file test_file_manager.cpp
+ * @author ghan, jiskim, yongjule
+ * @brief FileManager tests for file operations run on the disk I/O pool
+ * @date 2022-11-30
+ *
+ * @copyright Copyright (c) 2022
+ */
+
+#include <gtest/gtest.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+
+#include "AutoindexCache.hpp"
+#include "DiskIoPool.hpp"
+#include "ErrorPageCache.hpp"
+#include "FileManager.hpp"
+#include "OpenFileCache.hpp"
+#include "StaticResponseCache.hpp"
+
+OpenFileCache g_open_file_cache;
+StaticResponseCache g_static_response_cache;
+AutoindexCache g_autoindex_cache;
+ErrorPageCache g_error_page_cache;
+DiskIoPool g_disk_io_pool;
+
+// 작업이 끝날 때 까지 완료 알림 fd 를 기다리며 Execute 반복
+static ResponseManager::IoFdPair ExecuteUntilDone(FileManager& manager) {
+  ResponseManager::IoFdPair fds = manager.Execute();
+  for (int i = 0; i < 100 && fds.input != -1; ++i) {
+    struct pollfd done = {fds.input, POLLIN, 0};
+    poll(&done, 1, 100);
+    fds = manager.Execute();
+  }
+  return fds;
+}
+
+// 테스트용 임시 디렉토리 생성
+static std::string MakeTempDir(void) {
+  char dir_template[] = "/tmp/webserv_fm_XXXXXX";
+  return (mkdtemp(dir_template) == NULL) ? "" : dir_template;
+}
+
+// kPath 에 kContent 를 쓴 파일 생성
+static void WriteFile(const std::string& kPath, const std::string& kContent) {
+  std::ofstream ofs(kPath.c_str(), std::ios::binary);
+  ofs << kContent;
+}
+
+// kPath 파일을 GET 하고 작업이 끝날 때 까지 실행, 응답 버퍼는 response 에 복사
+static ResponseManager::Result RunGet(const std::string& kPath,
+                                      Request& request,
+                                      Router::Result& router_result,
+                                      ResponseBuffer* response = NULL) {
+  ResponseBuffer buffer;
+  router_result.success_path = kPath;
+  FileManager manager(true, buffer, router_result, request);
+  EXPECT_EQ(ExecuteUntilDone(manager).input, -1);
+  if (response != NULL) {
+    *response = buffer;
+  }
+  g_open_file_cache.Release(buffer.file_fd);
+  g_static_response_cache.Release(buffer.cached);
+  return manager.get_result();
+}
+
+// 헤더 하나만 가진 GET 요청
+static Request MakeGet(const std::string& kName = "",
+                       const std::string& kValue = "") {
+  Request request;
+  if (kName.empty() == false) {
+    request.header[kName].push_back(kValue);
+  }
+  return request;
+}
+
+TEST(FileManagerTest, FailedUploadIsNotRetried) {
+  ASSERT_TRUE(g_disk_io_pool.Start());
+  char dir_template[] = "/tmp/webserv_fm_XXXXXX";
+  ASSERT_NE(mkdtemp(dir_template), (char*)NULL);
+  const std::string kDir(dir_template);
+
+  // 쓰기 실패 (EFBIG) : 500, 부분 파일도 재시도한 빈 파일도 남지 않음
+  {
+    struct rlimit old_limit;
+    getrlimit(RLIMIT_FSIZE, &old_limit);
+    struct rlimit small_limit = old_limit;
+    small_limit.rlim_cur = 1024;
+    setrlimit(RLIMIT_FSIZE, &small_limit);
+    signal(SIGXFSZ, SIG_IGN);
+
+    ResponseBuffer response;
+    Request request;
+    request.req.method = POST;
+    request.content.assign(8192, 'a');
+    Router::Result router_result(200);
+    router_result.success_path = kDir + "/upload.txt";
+    FileManager manager(true, response, router_result, request);
+    ResponseManager::IoFdPair fds = ExecuteUntilDone(manager);
+    setrlimit(RLIMIT_FSIZE, &old_limit);
+
+    EXPECT_EQ(fds.input, -1);
+    EXPECT_EQ(manager.get_result().status, 500);
+    usleep(100000);  // 잘못 다시 넘긴 작업이 있다면 끝날 시간
+    EXPECT_EQ(access((kDir + "/upload.txt").c_str(), F_OK), -1);
+    EXPECT_EQ(access((kDir + "/upload_0.txt").c_str(), F_OK), -1);
+  }
+  // 없는 디렉토리 : 404, 다시 시도하지 않음
+  {
+    ResponseBuffer response;
+    Request request;
+    request.req.method = POST;
+    request.content = "content";
+    Router::Result router_result(200);
+    router_result.success_path = kDir + "/missing/upload.txt";
+    FileManager manager(true, response, router_result, request);
+    ResponseManager::IoFdPair fds = ExecuteUntilDone(manager);
+
+    EXPECT_EQ(fds.input, -1);
+    EXPECT_EQ(manager.get_result().status, 404);
+  }
+  // 성공 : 201, 내용이 모두 쓰임
+  {
+    ResponseBuffer response;
+    Request request;
+    request.req.method = POST;
+    request.content = "content";
+    Router::Result router_result(200);
+    router_result.success_path = kDir + "/upload.txt";
+    FileManager manager(true, response, router_result, request);
+    ResponseManager::IoFdPair fds = ExecuteUntilDone(manager);
+
+    EXPECT_EQ(fds.input, -1);
+    EXPECT_EQ(manager.get_result().status, 201);
+    struct stat file_stat;
+    ASSERT_EQ(stat((kDir + "/upload.txt").c_str(), &file_stat), 0);
+    EXPECT_EQ(file_stat.st_size, 7);
+  }
+  unlink((kDir + "/upload.txt").c_str());
+  rmdir(kDir.c_str());
+}
+
+TEST(FileManagerTest, ErrorPageDropsFileHeaders) {
+  ASSERT_TRUE(g_disk_io_pool.Start());
+  const std::string kDir = MakeTempDir();
+  ASSERT_FALSE(kDir.empty());
+  WriteFile(kDir + "/page.txt", std::string(100, 'a'));
+  WriteFile(kDir + "/page.txt.gz", std::string(40, 'z'));
+
+  // 사이드카를 고른 뒤 416 : 에러 페이지에 사이드카의 표현 헤더를 붙이지 않음
+  Request request;
+  request.header["accept-encoding"].push_back("gzip");
+  request.header["range"].push_back("bytes=500-600");
+  Router::Result router_result(200);
+  router_result.gzip_static = true;
+  ResponseManager::Result result =
+      RunGet(kDir + "/page.txt", request, router_result);
+
+  EXPECT_EQ(result.status, 416);
+  EXPECT_EQ(result.header["content-range"], "bytes */40");
+  EXPECT_EQ(result.header.count("content-encoding"), 0);
+  EXPECT_EQ(result.header.count("etag"), 0);
+  EXPECT_EQ(result.header.count("last-modified"), 0);
+  EXPECT_EQ(result.header.count("accept-ranges"), 0);
+  system(("rm -rf " + kDir).c_str());
+}
+
+TEST(FileManagerTest, RangeRequests) {
+  ASSERT_TRUE(g_disk_io_pool.Start());
+  const std::string kDir = MakeTempDir();
+  ASSERT_FALSE(kDir.empty());
+  std::string data;
+  for (int i = 0; i < 1000; ++i) {
+    data += static_cast<char>('0' + i % 10);
+  }
+  const std::string kPath = kDir + "/data.txt";
+  WriteFile(kPath, data);
+  Router::Result router_result(200);
+
+  ResponseBuffer response;
+  Request request = MakeGet();
+  ResponseManager::Result result = RunGet(kPath, request, router_result);
+  EXPECT_EQ(result.status, 200);
+  EXPECT_EQ(result.header["accept-ranges"], "bytes");
+  const std::string kLastModified = result.header["last-modified"];
+
+  // 범위 하나 : 파일의 해당 부분만 sendfile
+  const char* kSingle[][2] = {{"bytes=0-99", "bytes 0-99/1000"},
+                              {"bytes=-10", "bytes 990-999/1000"},
+                              {"bytes=995-", "bytes 995-999/1000"},
+                              {"bytes=900-5000", "bytes 900-999/1000"},
+                              {"bytes=2000-3000, 10-19", "bytes 10-19/1000"}};
+  for (size_t i = 0; i < sizeof(kSingle) / sizeof(kSingle[0]); ++i) {
+    request = MakeGet("range", kSingle[i][0]);
+    result = RunGet(kPath, request, router_result, &response);
+    EXPECT_EQ(result.status, 206) << kSingle[i][0];
+    EXPECT_EQ(result.header["content-range"], kSingle[i][1]) << kSingle[i][0];
+    EXPECT_NE(response.file_fd, -1) << kSingle[i][0];
+  }
+  request = MakeGet("range", "bytes=10-19");
+  RunGet(kPath, request, router_result, &response);
+  EXPECT_EQ(response.file_offset, 10);
+  EXPECT_EQ(response.file_size, 10);
+
+  // 만족하는 범위가 없으면 416
+  request = MakeGet("range", "bytes=1000-1100");
+  result = RunGet(kPath, request, router_result);
+  EXPECT_EQ(result.status, 416);
+  EXPECT_EQ(result.header["content-range"], "bytes */1000");
+
+  // 문법이 틀리거나 범위가 너무 많으면 Range 를 무시하고 전체 전송
+  std::string too_many = "bytes=0-0";
+  for (int i = 1; i <= RANGE_COUNT_MAX; ++i) {
+    too_many += ", " + std::string(1, '0' + i % 10) + "-" +
+                std::string(1, '0' + i % 10);
+  }
+  const char* kIgnored[] = {"bytes=abc", "items=0-1", "bytes=5-1", "bytes=-",
+                            too_many.c_str()};
+  for (size_t i = 0; i < sizeof(kIgnored) / sizeof(kIgnored[0]); ++i) {
+    request = MakeGet("range", kIgnored[i]);
+    result = RunGet(kPath, request, router_result);
+    EXPECT_EQ(result.status, 200) << kIgnored[i];
+    EXPECT_EQ(result.header.count("content-range"), 0) << kIgnored[i];
+  }
+
+  // 여러 범위 : multipart/byteranges
+  request = MakeGet("range", "bytes=0-9,20-24");
+  result = RunGet(kPath, request, router_result, &response);
+  EXPECT_EQ(result.status, 206);
+  const std::string kType = result.header["content-type"];
+  ASSERT_EQ(kType.find("multipart/byteranges; boundary="), 0);
+  const std::string kBoundary = kType.substr(kType.find('=') + 1);
+  EXPECT_EQ(response.file_fd, -1);
+  EXPECT_NE(response.content.find("content-range: bytes 0-9/1000" CRLF CRLF
+                                  "0123456789" CRLF "--" + kBoundary),
+            std::string::npos);
+  EXPECT_NE(response.content.find("content-range: bytes 20-24/1000" CRLF CRLF
+                                  "01234" CRLF "--" + kBoundary + "--" CRLF),
+            std::string::npos);
+
+  // If-Range 가 Last-Modified 와 같을 때만 Range 적용
+  request = MakeGet("range", "bytes=0-9");
+  request.header["if-range"].push_back(kLastModified);
+  EXPECT_EQ(RunGet(kPath, request, router_result).status, 206);
+  request = MakeGet("range", "bytes=0-9");
+  request.header["if-range"].push_back("Thu, 01 Jan 1970 00:00:00 GMT");
+  EXPECT_EQ(RunGet(kPath, request, router_result).status, 200);
+
+  // gzip 으로 보내는 파일도 Range 요청은 압축하지 않은 범위로 응답
+  GzipOption gzip;
+  gzip.is_on = true;
+  gzip.min_length = 0;
+  gzip.types.insert("text/plain");
+  router_result.gzip = &gzip;
+  request = MakeGet("accept-encoding", "gzip");
+  result = RunGet(kPath, request, router_result);
+  EXPECT_EQ(result.status, 200);
+  EXPECT_EQ(result.header["content-encoding"], "gzip");
+  request.header["range"].push_back("bytes=100-199");
+  result = RunGet(kPath, request, router_result, &response);
+  EXPECT_EQ(result.status, 206);
+  EXPECT_EQ(result.header["content-range"], "bytes 100-199/1000");
+  EXPECT_EQ(result.header.count("content-encoding"), 0);
+  EXPECT_EQ(response.file_size, 100);
+  system(("rm -rf " + kDir).c_str());
+}
+
+TEST(FileManagerTest, ConditionalRequests) {
+  ASSERT_TRUE(g_disk_io_pool.Start());
+  const std::string kDir = MakeTempDir();
+  ASSERT_FALSE(kDir.empty());
+  const std::string kPath = kDir + "/index.html";
+  WriteFile(kPath, "<html></html>");
+  Router::Result router_result(200);
+
+  Request request = MakeGet();
+  ResponseManager::Result result = RunGet(kPath, request, router_result);
+  EXPECT_EQ(result.status, 200);
+  const std::string kETag = result.header["etag"];
+  const std::string kLastModified = result.header["last-modified"];
+  ASSERT_EQ(kETag.compare(0, 3, "W/\""), 0);
+  const std::string kOpaqueTag = kETag.substr(2);
+
+  // If-None-Match : weak 비교, 리스트 중 하나라도 같거나 * 이면 304
+  const std::string kMatched[] = {kETag, kOpaqueTag, "*",
+                                  "\"other\", " + kETag,
+                                  " \"other\" ,W/" + kOpaqueTag + " "};
+  for (size_t i = 0; i < sizeof(kMatched) / sizeof(kMatched[0]); ++i) {
+    request = MakeGet("if-none-match", kMatched[i]);
+    result = RunGet(kPath, request, router_result);
+    EXPECT_EQ(result.status, 304) << kMatched[i];
+    EXPECT_EQ(result.header["etag"], kETag) << kMatched[i];
+  }
+  request = MakeGet("if-none-match", "\"other\"");
+  EXPECT_EQ(RunGet(kPath, request, router_result).status, 200);
+
+  // If-Modified-Since : 그 이후로 수정되지 않았으면 304, 잘못된 날짜는 무시
+  request = MakeGet("if-modified-since", kLastModified);
+  EXPECT_EQ(RunGet(kPath, request, router_result).status, 304);
+  request = MakeGet("if-modified-since", "Thu, 01 Jan 1970 00:00:00 GMT");
+  EXPECT_EQ(RunGet(kPath, request, router_result).status, 200);
+  request = MakeGet("if-modified-since", "yesterday");
+  EXPECT_EQ(RunGet(kPath, request, router_result).status, 200);
+
+  // If-None-Match 가 있으면 If-Modified-Since 는 무시
+  request = MakeGet("if-none-match", "\"other\"");
+  request.header["if-modified-since"].push_back(kLastModified);
+  EXPECT_EQ(RunGet(kPath, request, router_result).status, 200);
+  system(("rm -rf " + kDir).c_str());
+}
+
+TEST(FileManagerTest, CompressedResponseCache) {
+  ASSERT_TRUE(g_disk_io_pool.Start());
+  const std::string kDir = MakeTempDir();
+  ASSERT_FALSE(kDir.empty());
+  const std::string kPath = kDir + "/text.txt";
+  WriteFile(kPath, std::string(2000, 'x'));
+  GzipOption gzip;
+  gzip.is_on = true;
+  gzip.min_length = 0;
+  gzip.types.insert("text/plain");
+  Router::Result router_result(200);
+  router_result.gzip = &gzip;
+
+  // 압축한 응답은 원본과 따로 캐시되고 다음 요청이 그대로 사용
+  ResponseBuffer response;
+  Request request = MakeGet("accept-encoding", "gzip");
+  ResponseManager::Result result =
+      RunGet(kPath, request, router_result, &response);
+  ASSERT_NE(response.cached, (CachedResponse*)NULL);
+  EXPECT_EQ(result.header["content-encoding"], "gzip");
+  const CachedResponse* kGzipped = response.cached;
+  EXPECT_NE(kGzipped->blob.find("content-encoding: gzip" CRLF),
+            std::string::npos);
+  EXPECT_NE(kGzipped->blob.find("vary: Accept-Encoding" CRLF),
+            std::string::npos);
+  EXPECT_LT(kGzipped->blob.size(), 2000);
+  RunGet(kPath, request, router_result, &response);
+  EXPECT_EQ(response.cached, kGzipped);
+
+  request = MakeGet();
+  RunGet(kPath, request, router_result, &response);
+  ASSERT_NE(response.cached, (CachedResponse*)NULL);
+  EXPECT_NE(response.cached, kGzipped);
+  EXPECT_EQ(response.cached->blob.find("content-encoding"), std::string::npos);
+  EXPECT_NE(response.cached->blob.find("vary: Accept-Encoding" CRLF),
+            std::string::npos);
+
+  // gzip 이 꺼진 location 은 vary 없는 응답을 새로 만듦
+  GzipOption gzip_off;
+  Router::Result plain_result(200);
+  plain_result.gzip = &gzip_off;
+  RunGet(kPath, request, plain_result, &response);
+  ASSERT_NE(response.cached, (CachedResponse*)NULL);
+  EXPECT_EQ(response.cached->blob.find("vary"), std::string::npos);
+
+  // gzip_static 이 켜진 location 은 vary 를 붙인 응답을 다시 만듦
+  plain_result.gzip_static = true;
+  RunGet(kPath, request, plain_result, &response);
+  ASSERT_NE(response.cached, (CachedResponse*)NULL);
+  EXPECT_NE(response.cached->blob.find("vary: Accept-Encoding" CRLF),
+            std::string::npos);
+
+  // 압축 수준이 다른 location 은 압축한 응답을 다시 만듦
+  request = MakeGet("accept-encoding", "gzip");
+  RunGet(kPath, request, router_result, &response);
+  const int kLevel = response.cached->gzip_level;
+  gzip.level = 9;
+  RunGet(kPath, request, router_result, &response);
+  EXPECT_NE(kLevel, 9);
+  EXPECT_EQ(response.cached->gzip_level, 9);
+  system(("rm -rf " + kDir).c_str());
+}
+
+TEST(FileManagerTest, AcceptEncoding) {
+  ASSERT_TRUE(g_disk_io_pool.Start());
+  const std::string kDir = MakeTempDir();
+  ASSERT_FALSE(kDir.empty());
+  const std::string kPath = kDir + "/text.txt";
+  WriteFile(kPath, std::string(2000, 'x'));
+  GzipOption gzip;
+  gzip.is_on = true;
+  gzip.min_length = 0;
+  gzip.types.insert("text/plain");
+  Router::Result router_result(200);
+  router_result.gzip = &gzip;
+
+  // 직접 나열된 coding 의 q 가 '*' 보다 우선, q=0 은 거부
+  const char* kAccepted[] = {"gzip", "GZIP;Q=0.5", "br, gzip;q=0.1", "*",
+                             "br;q=0, *", "deflate, *;q=1"};
+  const char* kRejected[] = {"identity", "gzip;q=0", "gzip; q=0.0", "*;q=0",
+                             "gzip;q=0, *", "br, *;q=0"};
+  for (size_t i = 0; i < sizeof(kAccepted) / sizeof(kAccepted[0]); ++i) {
+    Request request = MakeGet("accept-encoding", kAccepted[i]);
+    ResponseManager::Result result = RunGet(kPath, request, router_result);
+    EXPECT_EQ(result.header["content-encoding"], "gzip") << kAccepted[i];
+  }
+  for (size_t i = 0; i < sizeof(kRejected) / sizeof(kRejected[0]); ++i) {
+    Request request = MakeGet("accept-encoding", kRejected[i]);
+    ResponseManager::Result result = RunGet(kPath, request, router_result);
+    EXPECT_EQ(result.header.count("content-encoding"), 0) << kRejected[i];
+  }
+  system(("rm -rf " + kDir).c_str());
+}
+
+TEST(FileManagerTest, CacheFillReadOnWorker) {
+  ASSERT_TRUE(g_disk_io_pool.Start());
+  const std::string kDir = MakeTempDir();
+  ASSERT_FALSE(kDir.empty());
+  const std::string kPath = kDir + "/small.txt";
+  WriteFile(kPath, "small file content");
+  Router::Result router_result(200);
+  Request request = MakeGet();
+
+  // open 하며 작업 스레드가 읽은 내용으로 캐시된 응답 생성
+  ResponseBuffer response;
+  RunGet(kPath, request, router_result, &response);
+  ASSERT_NE(response.cached, (CachedResponse*)NULL);
+  EXPECT_NE(response.cached->blob.find("small file content"),
+            std::string::npos);
+
+  // open file cache 에 있어도 캐시된 응답이 없으면 작업 스레드에서 읽음
+  g_static_response_cache.Invalidate(kPath);
+  ResponseBuffer buffer;
+  router_result.success_path = kPath;
+  FileManager manager(true, buffer, router_result, request);
+  EXPECT_NE(manager.Execute().input, -1);
+  EXPECT_EQ(ExecuteUntilDone(manager).input, -1);
+  ASSERT_NE(buffer.cached, (CachedResponse*)NULL);
+  EXPECT_NE(buffer.cached->blob.find("small file content"), std::string::npos);
+  g_static_response_cache.Release(buffer.cached);
+  system(("rm -rf " + kDir).c_str());
+}
+
+TEST(FileManagerTest, AutoindexReadOnWorker) {
+  ASSERT_TRUE(g_disk_io_pool.Start());
+  const std::string kDir = MakeTempDir();
+  ASSERT_FALSE(kDir.empty());
+  const std::string kList = kDir + "/list/";
+  ASSERT_EQ(mkdir(kList.c_str(), 0755), 0);
+  WriteFile(kList + "a.txt", "a");
+  struct timeval past[2] = {{1000000000, 0}, {1000000000, 0}};
+  ASSERT_EQ(utimes(kList.c_str(), past), 0);  // 캐시할 수 있는 mtime
+  Router::Result router_result(200);
+  Request request = MakeGet();
+
+  // 작업 스레드에서 읽어 만든 페이지를 캐시
+  ResponseBuffer response;
+  RunGet(kList, request, router_result, &response);
+  EXPECT_NE(response.content.find("a.txt"), std::string::npos);
+  struct stat dir_stat;
+  ASSERT_EQ(stat(kList.c_str(), &dir_stat), 0);
+  std::string listing;
+  EXPECT_TRUE(g_autoindex_cache.Find(kList, dir_stat.st_mtime, dir_stat.st_ino,
+                                     listing));
+
+  // 디렉토리가 그대로면 작업 스레드가 stat 만 하고 캐시된 페이지 사용
+  {
+    ResponseBuffer buffer;
+    router_result.success_path = kList;
+    FileManager manager(true, buffer, router_result, request);
+    EXPECT_NE(manager.Execute().input, -1);
+    EXPECT_EQ(ExecuteUntilDone(manager).input, -1);
+    EXPECT_EQ(buffer.content, response.content);
+  }
+  // 읽는 사이 캐시에서 빠지면 디렉토리를 다시 읽음
+  {
+    ResponseBuffer buffer;
+    FileManager manager(true, buffer, router_result, request);
+    EXPECT_NE(manager.Execute().input, -1);
+    g_autoindex_cache.Clear();
+    EXPECT_EQ(ExecuteUntilDone(manager).input, -1);
+    EXPECT_EQ(buffer.content, response.content);
+  }
+  // 디렉토리가 바뀌면 다시 읽음
+  WriteFile(kList + "b.txt", "b");
+  RunGet(kList, request, router_result, &response);
+  EXPECT_NE(response.content.find("b.txt"), std::string::npos);
+  system(("rm -rf " + kDir).c_str());
+}
+
+TEST(FileManagerTest, AutoindexThroughRootFd) {
+  ASSERT_TRUE(g_disk_io_pool.Start());
+  const std::string kDir = MakeTempDir();
+  ASSERT_FALSE(kDir.empty());
+  ASSERT_EQ(mkdir((kDir + "/sub").c_str(), 0755), 0);
+  ASSERT_EQ(mkdir((kDir + "/sub/dir").c_str(), 0755), 0);
+  WriteFile(kDir + "/sub/b.txt", "b");
+  WriteFile(kDir + "/sub/a.txt", "a");
+  WriteFile(kDir + "/sub/.hidden", "h");
+  Router::Result router_result(200);
+  router_result.root_fd = open(kDir.c_str(), O_RDONLY | O_DIRECTORY);
+  ASSERT_NE(router_result.root_fd, -1);
+  // 현재 디렉토리 기준으로는 없는 경로, root_fd 기준으로만 열 수 있음
+  const std::string kRoot = "./webserv_no_such_root/";
+  router_result.root_len = kRoot.size();
+
+  // 정렬한 전체 페이지 : 디렉토리가 먼저, 숨김 파일 제외
+  ResponseBuffer response;
+  Request request = MakeGet();
+  ResponseManager::Result result =
+      RunGet(kRoot + "sub/", request, router_result, &response);
+  EXPECT_EQ(result.status, 200);
+  EXPECT_TRUE(result.is_autoindex);
+  const std::string& kListing = response.content;
+  EXPECT_NE(kListing.find("dir/"), std::string::npos);
+  EXPECT_LT(kListing.find("dir/"), kListing.find("a.txt"));
+  EXPECT_LT(kListing.find("a.txt"), kListing.find("b.txt"));
+  EXPECT_EQ(kListing.find(".hidden"), std::string::npos);
+
+  // page, limit query : 정렬 순서로 해당 페이지만
+  request.req.query = "page=2&limit=1";
+  RunGet(kRoot + "sub/", request, router_result, &response);
+  EXPECT_NE(response.content.find("a.txt"), std::string::npos);
+  EXPECT_EQ(response.content.find("b.txt"), std::string::npos);
+  EXPECT_NE(response.content.find("page 2"), std::string::npos);
+
+  // 정렬하지 않으면 chunk 로 나눠 전송
+  request.req.query = "";
+  request.req.version = HttpParser::kHttp1_1;
+  router_result.autoindex_sort = false;
+  result = RunGet(kRoot + "sub/", request, router_result, &response);
+  EXPECT_TRUE(result.is_autoindex);
+  ASSERT_NE(response.autoindex_stream, (AutoindexStream*)NULL);
+  EXPECT_TRUE(response.autoindex_stream->is_done());
+  EXPECT_NE(response.content.find("b.txt"), std::string::npos);
+  delete response.autoindex_stream;
+
+#ifdef O_RESOLVE_BENEATH
+  // root 밖을 가리키는 심볼릭 링크는 따라가지 않음
+  ASSERT_EQ(symlink("/tmp", (kDir + "/sub/out").c_str()), 0);
+  router_result.autoindex_sort = true;
+  result = RunGet(kRoot + "sub/out/", request, router_result);
+  EXPECT_FALSE(result.is_autoindex);
+#endif
+  close(router_result.root_fd);
+  system(("rm -rf " + kDir).c_str());
+}
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <sys/socket.h>
 
 #include <fstream>
 #include <iostream>
@@ -65,7 +66,8 @@ void TestParseError(const std::string& file_path, int parser_status,
   int status;
   while (read(fd, buffer, BUFFER_SIZE) > 0) {
     std::string buf_str(buffer);
-    status = parser.Parse(buf_str);
+    size_t offset = 0;
+    status = parser.Parse(buf_str, offset);
     if (status >= HttpParser::kComplete) {
       break;
     }
@@ -200,6 +202,219 @@ EA%B2%83%EC%9D%80+%EA%B2%80%EC%83%89+%EC%BF%BC%EB%A6%AC%EB%AC%B8+%EC%\
   }
 }
 
+TEST(FieldsTest, KnownFieldLookup) {
+  const char* kKnown[Fields::kKnownFieldCount] = {
+      "host",          "content-length",    "transfer-encoding",
+      "connection",    "content-type",      "expect",
+      "range",         "if-range",          "if-none-match",
+      "if-modified-since", "accept-encoding"};
+  for (int i = 0; i < Fields::kKnownFieldCount; ++i) {
+    EXPECT_EQ(Fields::Lookup(kKnown[i]), i) << kKnown[i];
+  }
+  EXPECT_EQ(Fields::Lookup(""), Fields::kUnknown);
+  EXPECT_EQ(Fields::Lookup("accept"), Fields::kUnknown);
+  EXPECT_EQ(Fields::Lookup("hosts"), Fields::kUnknown);
+  EXPECT_EQ(Fields::Lookup("content-lengtH"), Fields::kUnknown);
+
+  Fields header;
+  header["accept"].push_back("ghan");
+  header["host"].push_back("jiskim");
+  header["accept"].push_back("yongjule");
+  EXPECT_EQ(header.size(), 2);
+  ASSERT_NE(header.find(Fields::kHost), header.end());
+  EXPECT_EQ(header.find(Fields::kHost)->second.front(), "jiskim");
+  EXPECT_EQ(header.find(Fields::kContentLength), header.end());
+  EXPECT_EQ(header.count("accept"), 1);
+  EXPECT_EQ(header["accept"].size(), 2);
+  EXPECT_EQ(header["accept"].back(), "yongjule");
+}
+
+#define CHUNKED_HEADER                               \
+  "POST /upload HTTP/1.1\r\nHost: localhost\r\n" \
+  "Transfer-Encoding: chunked\r\n\r\n"
+
+// segment 들을 차례로 받은 것처럼 파싱, 파싱이 끝나면 멈춤
+int ParseSegments(HttpParser& parser, const char* const* kSegments,
+                  size_t count, size_t* offset = NULL) {
+  int status = HttpParser::kLeadingCRLF;
+  for (size_t i = 0; i < count; ++i) {
+    std::string segment(kSegments[i]);
+    size_t segment_offset = 0;
+    status = parser.Parse(segment, segment_offset);
+    if (offset != NULL) {
+      *offset = segment_offset;
+    }
+    if (status >= HttpParser::kComplete) {
+      break;
+    }
+  }
+  return status;
+}
+
+TEST(HttpParserTest, ChunkedContent) {
+  // chunk size 가 두 segment 에 나뉘어 옴 (1 | A = 26)
+  {
+    HttpParser parser;
+    const char* kSegments[] = {CHUNKED_HEADER "1",
+                               "A\r\nabcdefghijklm",
+                               "nopqrstuvwxyz\r\n0\r\n", "\r\n"};
+    size_t offset = 0;
+    EXPECT_EQ(ParseSegments(parser, kSegments, 4, &offset),
+              HttpParser::kComplete);
+    EXPECT_EQ(offset, 2);
+    EXPECT_EQ(parser.get_result().status, 200);
+    EXPECT_EQ(parser.get_result().request.content,
+              "abcdefghijklmnopqrstuvwxyz");
+  }
+  // chunk extension 과 BWS 는 무시
+  {
+    HttpParser parser;
+    const char* kSegments[] = {CHUNKED_HEADER
+                               "5;name=value\r\nhello\r\n"
+                               "6 ; ext=\"q\"\r\n world\r\n"
+                               "0;last\r\n\r\n"};
+    EXPECT_EQ(ParseSegments(parser, kSegments, 1), HttpParser::kComplete);
+    EXPECT_EQ(parser.get_result().status, 200);
+    EXPECT_EQ(parser.get_result().request.content, "hello world");
+  }
+  // chunk_max 를 넘는 chunk 는 거부
+  {
+    HttpParser parser;
+    parser.set_chunk_max(16);
+    const char* kSegments[] = {CHUNKED_HEADER "10\r\n0123456789abcdef\r\n",
+                               "11\r\n0123456789abcdefg\r\n0\r\n\r\n"};
+    EXPECT_EQ(ParseSegments(parser, kSegments, 2), HttpParser::kClose);
+    EXPECT_EQ(parser.get_result().status, 400);
+  }
+  // chunk data 뒤에 CRLF 가 없거나 잘못됨
+  {
+    const char* kBadDelimiters[] = {CHUNKED_HEADER "5\r\nhello0\r\n\r\n",
+                                    CHUNKED_HEADER "5\r\nhelloX\r\n0\r\n\r\n",
+                                    CHUNKED_HEADER "5\r\nhello\rX0\r\n\r\n",
+                                    CHUNKED_HEADER "5\r\nhello\n0\r\n\r\n"};
+    for (size_t i = 0; i < 4; ++i) {
+      HttpParser parser;
+      EXPECT_EQ(ParseSegments(parser, kBadDelimiters + i, 1),
+                HttpParser::kClose)
+          << i;
+      EXPECT_EQ(parser.get_result().status, 400) << i;
+    }
+  }
+  // chunk size 라인의 0x80 이상 바이트
+  {
+    HttpParser parser;
+    const char* kSegments[] = {CHUNKED_HEADER "\xff\r\n0\r\n\r\n"};
+    EXPECT_EQ(ParseSegments(parser, kSegments, 1), HttpParser::kClose);
+    EXPECT_EQ(parser.get_result().status, 400);
+  }
+}
+
+TEST(HttpParserTest, PipelinedRequests) {
+  // 한 버퍼에 연속된 요청들을 offset 으로 차례로 파싱
+  {
+    HttpParser parser;
+    const std::string kBuf(
+        "GET /a HTTP/1.1\r\nHost: localhost\r\n\r\n"
+        "POST /b HTTP/1.1\r\nHost: localhost\r\nContent-Length: 5\r\n\r\n"
+        "hello"
+        "DELETE /c HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    size_t offset = 0;
+    ASSERT_EQ(parser.Parse(kBuf, offset), HttpParser::kComplete);
+    EXPECT_EQ(parser.get_result().request.req.method, GET);
+    EXPECT_EQ(parser.get_result().request.req.path, "/a");
+    EXPECT_EQ(kBuf.compare(offset, 4, "POST"), 0);
+    parser.Clear();
+    ASSERT_EQ(parser.Parse(kBuf, offset), HttpParser::kComplete);
+    EXPECT_EQ(parser.get_result().request.req.method, POST);
+    EXPECT_EQ(parser.get_result().request.content, "hello");
+    EXPECT_EQ(kBuf.compare(offset, 6, "DELETE"), 0);
+    parser.Clear();
+    ASSERT_EQ(parser.Parse(kBuf, offset), HttpParser::kComplete);
+    EXPECT_EQ(parser.get_result().request.req.method, DELETE);
+    EXPECT_EQ(offset, kBuf.size());
+  }
+  // 요청 라인, 헤더, content 가 두 번에 나뉘어 옴
+  {
+    const char* kSplits[][2] = {
+        {"GET /a HT", "TP/1.1\r\nHost: localhost\r\n\r\n"},
+        {"GET /a HTTP/1.1\r", "\nHost: localhost\r\n\r\n"},
+        {"GET /a HTTP/1.1\r\nHost: loc", "alhost\r\n\r\n"},
+        {"GET /a HTTP/1.1\r\nHost: localhost\r\n\r", "\n"},
+        {"POST /a HTTP/1.1\r\nHost: localhost\r\nContent-Length: 5\r\n\r\nhe",
+         "llo"}};
+    for (size_t i = 0; i < sizeof(kSplits) / sizeof(kSplits[0]); ++i) {
+      HttpParser parser;
+      size_t offset = 0;
+      EXPECT_LT(parser.Parse(kSplits[i][0], offset), HttpParser::kComplete)
+          << i;
+      EXPECT_EQ(offset, strlen(kSplits[i][0])) << i;
+      std::string second(kSplits[i][1]);
+      offset = 0;
+      EXPECT_EQ(parser.Parse(second, offset), HttpParser::kComplete) << i;
+      EXPECT_EQ(offset, second.size()) << i;
+      EXPECT_EQ(parser.get_result().status, 200) << i;
+      EXPECT_EQ(parser.get_result().request.req.path, "/a") << i;
+    }
+  }
+  // 에러 응답 이후 남은 데이터는 버림
+  {
+    const std::string kBufs[] = {
+        "GET /a HTTP/9.9\r\nHost: localhost\r\n\r\nGET /b HTTP/1.1\r\n\r\n",
+        "PURGE /a HTTP/1.1\r\nHost: localhost\r\n\r\nGET /b HTTP/1.1\r\n\r\n"};
+    const int kStatuses[] = {505, 405};
+    for (size_t i = 0; i < 2; ++i) {
+      HttpParser parser;
+      size_t offset = 0;
+      EXPECT_GE(parser.Parse(kBufs[i], offset), HttpParser::kComplete) << i;
+      EXPECT_EQ(parser.get_result().status, kStatuses[i]) << i;
+      EXPECT_EQ(offset, kBufs[i].size()) << i;
+    }
+  }
+}
+
+TEST(ConnectionTest, PipelineLimits) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  const int kRequestCount = RESPONSE_QUEUE_MAX + 8;
+  std::string requests;
+  for (int i = 0; i < kRequestCount; ++i) {
+    requests += "GET /missing HTTP/1.1\r\nHost: localhost\r\n\r\n";
+  }
+  ASSERT_LE(requests.size(), BUFFER_SIZE);
+  ASSERT_EQ(write(fds[1], requests.data(), requests.size()),
+            (ssize_t)requests.size());
+
+  ServerRouter server_router;
+  Connection connection;
+  connection.SetAttributes(fds[0], "127.0.0.1", HostPortPair(),
+                           server_router);
+  // 한 이벤트에서 PIPELINE_REQUEST_MAX 개 까지만 처리
+  int handled_count = 0;
+  do {
+    connection.HandleRequest();
+    ASSERT_EQ(connection.get_connection_status(), NEXT_REQUEST_EXISTS);
+  } while (connection.CanHandleNextRequest(++handled_count) == true);
+  EXPECT_EQ(handled_count, PIPELINE_REQUEST_MAX);
+  EXPECT_TRUE(connection.HasPipelinedRequest());
+  EXPECT_FALSE(connection.IsResponseQueueFull());
+
+  // 응답을 보내지 않으면 응답 큐가 가득 찰 때 멈춤
+  for (int wakeup = 0; wakeup < kRequestCount; ++wakeup) {
+    handled_count = 0;
+    do {
+      connection.HandleRequest();
+    } while (connection.CanHandleNextRequest(++handled_count) == true);
+    if (connection.IsResponseQueueFull() == true) {
+      break;
+    }
+  }
+  EXPECT_TRUE(connection.IsResponseQueueFull());
+  EXPECT_TRUE(connection.HasPipelinedRequest());
+  EXPECT_FALSE(connection.CanHandleNextRequest(0));
+  connection.Clear();
+  close(fds[1]);
+}
+
 // TEST(HttpParserTest, ParseRequestLine) {
 //   char buffer[BUFFER_SIZE + 1];
 //   {
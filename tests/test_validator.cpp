@@ -3,6 +3,7 @@
 #include <fstream>
 #include <sstream>
 
+#include "MimeMap.hpp"
 #include "Validator.hpp"
 
 #define PATH_PREFIX "../configs/tests/validator/"
@@ -743,3 +744,64 @@ TEST(ValidatorTest, RouteBlock) {
   }
   // TestSyntaxException
 }
+
+// 기본 타입이 모두 자기 MIME 타입으로 조회되는지, 확장자 뒤에 문자가 더 있는
+// 버퍼의 (ptr, len) 조회도 같은 결과인지 확인
+static void ExpectTypesFound(const MimeMap& kMap, const MimeTypeList& kTypes) {
+  for (MimeTypeList::const_iterator it = kTypes.begin(); it != kTypes.end();
+       ++it) {
+    const std::string* kType = kMap.Find(it->first);
+    ASSERT_NE(kType, (const std::string*)NULL) << it->first;
+    EXPECT_EQ(*kType, it->second) << it->first;
+    const std::string kBuf = "index." + it->first + "?q=1";
+    kType = kMap.Find(kBuf.data() + 6, it->first.size());
+    ASSERT_NE(kType, (const std::string*)NULL) << it->first;
+    EXPECT_EQ(*kType, it->second) << it->first;
+  }
+}
+
+TEST(MimeMapTest, DefaultTypes) {
+  MimeMap mime_map;
+  const MimeTypeList kDefaults = MimeMap::GetDefaultTypes();
+  ASSERT_FALSE(kDefaults.empty());
+  ExpectTypesFound(mime_map, kDefaults);
+
+  const char* kUnknown[] = {"", "xyz", "ht", "htmlx", "tar.gz"};
+  for (size_t i = 0; i < sizeof(kUnknown) / sizeof(kUnknown[0]); ++i) {
+    EXPECT_EQ(mime_map.Find(kUnknown[i]), (const std::string*)NULL)
+        << kUnknown[i];
+  }
+  EXPECT_EQ(mime_map.Find("html", 2), (const std::string*)NULL);
+  EXPECT_EQ(MimeMap().Find("", 0), (const std::string*)NULL);
+}
+
+TEST(MimeMapTest, TypesBlockOverride) {
+  ServerConfig result = TestValidatorSuccess(PATH_PREFIX "TypesBlock/case_00");
+  ASSERT_EQ(result.mime_types.size(), 3);
+
+  MimeMap mime_map;
+  mime_map.Add(result.mime_types);
+  ASSERT_NE(mime_map.Find("html"), (const std::string*)NULL);
+  EXPECT_EQ(*mime_map.Find("html"), "text/plain");
+  ASSERT_NE(mime_map.Find("md"), (const std::string*)NULL);
+  EXPECT_EQ(*mime_map.Find("md"), "text/plain");
+  ASSERT_NE(mime_map.Find("toml"), (const std::string*)NULL);
+  EXPECT_EQ(*mime_map.Find("toml"), "application/toml");
+  EXPECT_EQ(mime_map.Find("xyz"), (const std::string*)NULL);
+
+  // 덮어쓰지 않은 기본 타입은 그대로 남음
+  MimeTypeList untouched;
+  const MimeTypeList kDefaults = MimeMap::GetDefaultTypes();
+  for (MimeTypeList::const_iterator it = kDefaults.begin();
+       it != kDefaults.end(); ++it) {
+    if (it->first != "html" && it->first != "md") {
+      untouched.push_back(*it);
+    }
+  }
+  ExpectTypesFound(mime_map, untouched);
+
+  // 한 번에 하나씩 추가해도 마지막 타입이 남음
+  mime_map.Add("toml", "text/plain");
+  EXPECT_EQ(*mime_map.Find("toml"), "text/plain");
+  ExpectTypesFound(mime_map, untouched);
+}